@@ -41,6 +41,7 @@ void DallasTemperature::setOneWire(OneWire* _oneWire){
 
     _wire = _oneWire;
     devices = 0;
+    cachedDevices = 0;
     parasite = false;
     bitResolution = 9;
     waitForConversion = true;
@@ -49,12 +50,16 @@ void DallasTemperature::setOneWire(OneWire* _oneWire){
 }
 
 // initialise the bus
+// every valid device is also stored in the cache so that index based
+// lookups do not have to walk the bus again
 void DallasTemperature::begin(void){
 
     DeviceAddress deviceAddress;
 
     _wire->reset_search();
     devices = 0; // Reset the number of devices when we enumerate wire devices
+    cachedDevices = 0;
+    parasite = false;
 
     while (_wire->search(deviceAddress)){
 
@@ -64,12 +69,22 @@ void DallasTemperature::begin(void){
 
             bitResolution = max(bitResolution, getResolution(deviceAddress));
 
+            if (cachedDevices < DEVICECACHESIZE){
+                memcpy(deviceCache[cachedDevices++], deviceAddress, sizeof(DeviceAddress));
+            }
+
             devices++;
         }
     }
 
 }
 
+// search the bus again and rebuild the device cache
+uint8_t DallasTemperature::rescan(void){
+    begin();
+    return devices;
+}
+
 // returns the number of devices found on the bus
 uint8_t DallasTemperature::getDeviceCount(void){
     return devices;
@@ -82,8 +97,14 @@ bool DallasTemperature::validAddress(const uint8_t* deviceAddress){
 
 // finds an address at a given index on the bus
 // returns true if the device was found
+// cached devices are returned without any bus traffic
 bool DallasTemperature::getAddress(uint8_t* deviceAddress, uint8_t index){
 
+    if (index < cachedDevices){
+        memcpy(deviceAddress, deviceCache[index], sizeof(DeviceAddress));
+        return true;
+    }
+
     uint8_t depth = 0;
 
     _wire->reset_search();
@@ -144,7 +165,7 @@ bool DallasTemperature::readScratchPad(const uint8_t* deviceAddress, uint8_t* sc
 }
 
 
-void DallasTemperature::writeScratchPad(const uint8_t* deviceAddress, const uint8_t* scratchPad){
+void DallasTemperature::writeScratchPad(const uint8_t* deviceAddress, const uint8_t* scratchPad, bool save){
 
     _wire->reset();
     _wire->select(deviceAddress);
@@ -157,6 +178,9 @@ void DallasTemperature::writeScratchPad(const uint8_t* deviceAddress, const uint
 
     _wire->reset();
 
+    // the EEPROM copy blocks for 20ms and wears the EEPROM, skip it when not needed
+    if (!save) return;
+
     // save the newly written values to eeprom
     _wire->select(deviceAddress);
     _wire->write(COPYSCRATCH, parasite);
@@ -182,21 +206,22 @@ bool DallasTemperature::readPowerSupply(const uint8_t* deviceAddress){
 
 // set resolution of all devices to 9, 10, 11, or 12 bits
 // if new resolution is out of range, it is constrained.
-void DallasTemperature::setResolution(uint8_t newResolution){
+// the resolution is saved to the devices' EEPROM only when save is true.
+void DallasTemperature::setResolution(uint8_t newResolution, bool save){
 
     bitResolution = constrain(newResolution, 9, 12);
     DeviceAddress deviceAddress;
     for (int i=0; i<devices; i++)
     {
         getAddress(deviceAddress, i);
-        setResolution(deviceAddress, bitResolution, true);
+        setResolution(deviceAddress, bitResolution, true, save);
     }
 
 }
 
 // set resolution of a device to 9, 10, 11, or 12 bits
 // if new resolution is out of range, 9 bits is used.
-bool DallasTemperature::setResolution(const uint8_t* deviceAddress, uint8_t newResolution, bool skipGlobalBitResolutionCalculation){
+bool DallasTemperature::setResolution(const uint8_t* deviceAddress, uint8_t newResolution, bool skipGlobalBitResolutionCalculation, bool save){
 
 	// ensure same behavior as setResolution(uint8_t newResolution)
 	newResolution = constrain(newResolution, 9, 12);
@@ -225,7 +250,7 @@ bool DallasTemperature::setResolution(const uint8_t* deviceAddress, uint8_t newR
                 scratchPad[CONFIGURATION] = TEMP_9_BIT;
                 break;
             }
-            writeScratchPad(deviceAddress, scratchPad);
+            writeScratchPad(deviceAddress, scratchPad, save);
 
             // without calculation we can always set it to max
 			bitResolution = max(bitResolution, newResolution);
@@ -404,6 +429,18 @@ float DallasTemperature::getTempCByIndex(uint8_t deviceIndex){
 
 }
 
+// Fetch raw temperature for device index, without any float conversion
+int16_t DallasTemperature::getTempByIndex(uint8_t deviceIndex){
+
+    DeviceAddress deviceAddress;
+    if (!getAddress(deviceAddress, deviceIndex)){
+        return DEVICE_DISCONNECTED_RAW;
+    }
+
+    return getTemp((uint8_t*)deviceAddress);
+
+}
+
 // Fetch temperature for device index
 float DallasTemperature::getTempFByIndex(uint8_t deviceIndex){
 
@@ -18,6 +18,12 @@
 #define REQUIRESALARMS true
 #endif
 
+// number of devices whose address is cached by begin()
+// devices found beyond this count are still counted but located by a bus search
+#ifndef DEVICECACHESIZE
+#define DEVICECACHESIZE 4
+#endif
+
 #include <inttypes.h>
 #include <OneWire.h>
 
@@ -70,9 +76,13 @@ public:
 
     void setOneWire(OneWire*);
 
-    // initialise bus
+    // initialise bus and fill the device cache
     void begin(void);
 
+    // searches the bus again, e.g. after a probe has been hot-plugged,
+    // and returns the number of devices found
+    uint8_t rescan(void);
+
     // returns the number of devices found on the bus
     uint8_t getDeviceCount(void);
 
@@ -95,8 +105,8 @@ public:
     // read device's scratchpad
     bool readScratchPad(const uint8_t*, uint8_t*);
 
-    // write device's scratchpad
-    void writeScratchPad(const uint8_t*, const uint8_t*);
+    // write device's scratchpad, and copy it to the device's EEPROM when save is true
+    void writeScratchPad(const uint8_t*, const uint8_t*, bool save = true);
 
     // read device's power requirements
     bool readPowerSupply(const uint8_t*);
@@ -105,13 +115,16 @@ public:
     uint8_t getResolution();
 
     // set global resolution to 9, 10, 11, or 12 bits
-    void setResolution(uint8_t);
+    // with save false, the resolution is only written to the scratchpads: nothing is
+    // written to the devices' EEPROM, which suits frequent changes, and the devices
+    // go back to their saved resolution at power up
+    void setResolution(uint8_t, bool save = true);
 
     // returns the device resolution: 9, 10, 11, or 12 bits
     uint8_t getResolution(const uint8_t*);
 
     // set resolution of a device to 9, 10, 11, or 12 bits
-    bool setResolution(const uint8_t*, uint8_t, bool skipGlobalBitResolutionCalculation = false);
+    bool setResolution(const uint8_t*, uint8_t, bool skipGlobalBitResolutionCalculation = false, bool save = true);
 
     // sets/gets the waitForConversion flag
     void setWaitForConversion(bool);
@@ -142,6 +155,10 @@ public:
     // Get temperature for device index (slow)
     float getTempCByIndex(uint8_t);
 
+    // Get raw temperature (1/128 degrees C) for device index (slow)
+    // returns DEVICE_DISCONNECTED_RAW if the device cannot be read
+    int16_t getTempByIndex(uint8_t);
+
     // Get temperature for device index (slow)
     float getTempFByIndex(uint8_t);
 
@@ -231,6 +248,10 @@ public:
 private:
     typedef uint8_t ScratchPad[9];
 
+    // addresses found by begin()
+    DeviceAddress deviceCache[DEVICECACHESIZE];
+    uint8_t cachedDevices;
+
     // parasite power on or off
     bool parasite;
 
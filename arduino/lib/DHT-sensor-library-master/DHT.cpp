@@ -8,6 +8,13 @@ written by Adafruit Industries
 
 #define MIN_INTERVAL 2000
 
+// Duration of the start signal and maximum duration of the asynchronous
+// capture, in milliseconds.
+#define START_SIGNAL 20
+#define CAPTURE_TIMEOUT 10
+
+DHT* DHT::_active = NULL;
+
 DHT::DHT(uint8_t pin, uint8_t type, uint8_t count) {
   _pin = pin;
   _type = type;
@@ -15,8 +22,12 @@ DHT::DHT(uint8_t pin, uint8_t type, uint8_t count) {
     _bit = digitalPinToBitMask(pin);
     _port = digitalPinToPort(pin);
   #endif
-  _maxcycles = microsecondsToClockCycles(1000);  // 1 millisecond timeout for
-                                                 // reading pulses from DHT sensor.
+  // 1 millisecond timeout for reading pulses from DHT sensor, counted in loop
+  // iterations of at least one clock cycle so that a 16 bit counter is enough.
+  _maxcycles = min(microsecondsToClockCycles(1000), 0xFFFFL);
+  _state = DHT_IDLE;
+  _ready = false;
+  _lastresult = false;
   // Note that count is now ignored as the DHT reading algorithm adjusts itself
   // basd on the speed of the processor.
 }
@@ -28,7 +39,7 @@ void DHT::begin(void) {
   // >= MIN_INTERVAL right away. Note that this assignment wraps around,
   // but so will the subtraction.
   _lastreadtime = -MIN_INTERVAL;
-  DEBUG_PRINT("Max clock cycles: "); DEBUG_PRINTLN(_maxcycles, DEC);
+  DEBUG_PRINT(F("Max clock cycles: ")); DEBUG_PRINTLN(_maxcycles, DEC);
 }
 
 //boolean S == Scale.  True == Fahrenheit; False == Celcius
@@ -36,27 +47,42 @@ float DHT::readTemperature(bool S, bool force) {
   float f = NAN;
 
   if (read(force)) {
-    switch (_type) {
-    case DHT11:
-      f = data[2];
-      if(S) {
-        f = convertCtoF(f);
-      }
-      break;
-    case DHT22:
-    case DHT21:
-      f = data[2] & 0x7F;
-      f *= 256;
-      f += data[3];
-      f *= 0.1;
-      if (data[2] & 0x80) {
-        f *= -1;
-      }
-      if(S) {
-        f = convertCtoF(f);
-      }
-      break;
+    f = convertTemperature(S);
+  }
+  return f;
+}
+
+// Returns the temperature decoded by the last read, NAN if it failed.
+float DHT::getTemperature(bool S) {
+  if (!_lastresult) {
+    return NAN;
+  }
+  return convertTemperature(S);
+}
+
+float DHT::convertTemperature(bool S) {
+  float f = NAN;
+
+  switch (_type) {
+  case DHT11:
+    f = data[2];
+    if(S) {
+      f = convertCtoF(f);
+    }
+    break;
+  case DHT22:
+  case DHT21:
+    f = data[2] & 0x7F;
+    f *= 256;
+    f += data[3];
+    f *= 0.1;
+    if (data[2] & 0x80) {
+      f *= -1;
+    }
+    if(S) {
+      f = convertCtoF(f);
     }
+    break;
   }
   return f;
 }
@@ -72,22 +98,84 @@ float DHT::convertFtoC(float f) {
 float DHT::readHumidity(bool force) {
   float f = NAN;
   if (read()) {
-    switch (_type) {
-    case DHT11:
-      f = data[0];
-      break;
-    case DHT22:
-    case DHT21:
-      f = data[0];
-      f *= 256;
-      f += data[1];
-      f *= 0.1;
-      break;
-    }
+    f = convertHumidity();
+  }
+  return f;
+}
+
+// Returns the humidity decoded by the last read, NAN if it failed.
+float DHT::getHumidity(void) {
+  if (!_lastresult) {
+    return NAN;
+  }
+  return convertHumidity();
+}
+
+float DHT::convertHumidity(void) {
+  float f = NAN;
+  switch (_type) {
+  case DHT11:
+    f = data[0];
+    break;
+  case DHT22:
+  case DHT21:
+    f = data[0];
+    f *= 256;
+    f += data[1];
+    f *= 0.1;
+    break;
   }
   return f;
 }
 
+// Returns the temperature decoded by the last read in 1/128 degree Celsius,
+// DHT_FIXED_INVALID if it failed. DHT22 values come in tenths of degree.
+int16_t DHT::getFixedTemperature(void) {
+  if (!_lastresult) {
+    return DHT_FIXED_INVALID;
+  }
+  int32_t tenths;
+  switch (_type) {
+  case DHT11:
+    return (int16_t)data[2] << 7;
+  case DHT22:
+  case DHT21:
+    tenths = ((int32_t)(data[2] & 0x7F) << 8) | data[3];
+    tenths = (tenths * 64 + 2) / 5;
+    return data[2] & 0x80 ? -tenths : tenths;
+  }
+  return DHT_FIXED_INVALID;
+}
+
+// Returns the humidity decoded by the last read in 1/128 percent,
+// DHT_FIXED_INVALID if it failed. DHT22 values come in tenths of percent.
+int16_t DHT::getFixedHumidity(void) {
+  if (!_lastresult) {
+    return DHT_FIXED_INVALID;
+  }
+  switch (_type) {
+  case DHT11:
+    return (int16_t)data[0] << 7;
+  case DHT22:
+  case DHT21:
+    return ((((int32_t)data[0] << 8) | data[1]) * 64 + 2) / 5;
+  }
+  return DHT_FIXED_INVALID;
+}
+
+// Returns the temperature word sent by the sensor for the last read: tenths
+// of degree with a sign bit for a DHT22, whole degrees then a decimal byte
+// for a DHT11.
+uint16_t DHT::getRawTemperature(void) {
+  return ((uint16_t)data[2] << 8) | data[3];
+}
+
+// Returns the humidity word sent by the sensor for the last read, encoded
+// the same way as the temperature, without sign bit.
+uint16_t DHT::getRawHumidity(void) {
+  return ((uint16_t)data[0] << 8) | data[1];
+}
+
 //boolean isFahrenheit: True == Fahrenheit; False == Celcius
 float DHT::computeHeatIndex(float temperature, float percentHumidity, bool isFahrenheit) {
   // Using both Rothfusz and Steadman's equations
@@ -145,7 +233,7 @@ boolean DHT::read(bool force) {
   digitalWrite(_pin, LOW);
   delay(20);
 
-  uint32_t cycles[80];
+  bool timeout = false;
   {
     // Turn off interrupts temporarily because the next sections are timing critical
     // and we don't want any interruptions.
@@ -178,35 +266,37 @@ boolean DHT::read(bool force) {
     // then it's a 1.  We measure the cycle count of the initial 50us low pulse
     // and use that to compare to the cycle count of the high pulse to determine
     // if the bit is a 0 (high state cycle count < low state cycle count), or a
-    // 1 (high state cycle count > low state cycle count). Note that for speed all
-    // the pulses are read into a array and then examined in a later step.
-    for (int i=0; i<80; i+=2) {
-      cycles[i]   = expectPulse(LOW);
-      cycles[i+1] = expectPulse(HIGH);
+    // 1 (high state cycle count > low state cycle count). Each bit is decoded
+    // as soon as its high pulse ends, while the sensor sends the next low
+    // pulse: only two 16 bit counts are kept instead of an array of 80 pulses.
+    // The work between two pulses takes about as long as the 32 bit array store
+    // it replaces, so the low pulse count is shortened by the same few cycles,
+    // and the 16 bit counting loop is faster, which gives finer counts.
+    for (uint8_t i=0; i<40; ++i) {
+      uint16_t lowCycles  = expectPulse(LOW);
+      uint16_t highCycles = expectPulse(HIGH);
+      if ((lowCycles == 0) || (highCycles == 0)) {
+        timeout = true;
+        break;
+      }
+      // High cycles greater than the 50us low cycle count make a 1, less than
+      // (or equal to, a weird case) make a 0.
+      data[i/8] = (data[i/8] << 1) | (highCycles > lowCycles);
     }
   } // Timing critical code is now complete.
 
-  // Inspect pulses and determine which ones are 0 (high state cycle count < low
-  // state cycle count), or 1 (high state cycle count > low state cycle count).
-  for (int i=0; i<40; ++i) {
-    uint32_t lowCycles  = cycles[2*i];
-    uint32_t highCycles = cycles[2*i+1];
-    if ((lowCycles == 0) || (highCycles == 0)) {
-      DEBUG_PRINTLN(F("Timeout waiting for pulse."));
-      _lastresult = false;
-      return _lastresult;
-    }
-    data[i/8] <<= 1;
-    // Now compare the low and high cycle times to see if the bit is a 0 or 1.
-    if (highCycles > lowCycles) {
-      // High cycles are greater than 50us low cycle count, must be a 1.
-      data[i/8] |= 1;
-    }
-    // Else high cycles are less than (or equal to, a weird case) the 50us low
-    // cycle count so this must be a zero.  Nothing needs to be changed in the
-    // stored data.
+  if (timeout) {
+    DEBUG_PRINTLN(F("Timeout waiting for pulse."));
+    _lastresult = false;
+    return _lastresult;
   }
 
+  _lastresult = checkData();
+  return _lastresult;
+}
+
+// Check we read 40 bits and that the checksum matches.
+bool DHT::checkData(void) {
   DEBUG_PRINTLN(F("Received:"));
   DEBUG_PRINT(data[0], HEX); DEBUG_PRINT(F(", "));
   DEBUG_PRINT(data[1], HEX); DEBUG_PRINT(F(", "));
@@ -215,18 +305,186 @@ boolean DHT::read(bool force) {
   DEBUG_PRINT(data[4], HEX); DEBUG_PRINT(F(" =? "));
   DEBUG_PRINTLN((data[0] + data[1] + data[2] + data[3]) & 0xFF, HEX);
 
-  // Check we read 40 bits and that the checksum matches.
   if (data[4] == ((data[0] + data[1] + data[2] + data[3]) & 0xFF)) {
-    _lastresult = true;
-    return _lastresult;
+    return true;
   }
-  else {
-    DEBUG_PRINTLN(F("Checksum failure!"));
-    _lastresult = false;
-    return _lastresult;
+  DEBUG_PRINTLN(F("Checksum failure!"));
+  return false;
+}
+
+// Start an asynchronous read: pull the data line low for the start signal
+// and return immediately. Returns false if a read is already running or if
+// the sensor was read less than two seconds ago, in which case the last
+// result stays available.
+bool DHT::startRead(bool force) {
+  uint32_t currenttime = millis();
+  if (_state != DHT_IDLE) {
+    return false;
+  }
+  if (!force && ((currenttime - _lastreadtime) < MIN_INTERVAL)) {
+    return false;
   }
+  _lastreadtime = currenttime;
+  _ready = false;
+
+  #ifdef __AVR
+    // First set data line low for the start signal, update() releases it.
+    pinMode(_pin, OUTPUT);
+    digitalWrite(_pin, LOW);
+    _statetime = currenttime;
+    _state = DHT_START;
+  #else
+    // No pin change capture on this platform, fall back to a blocking read.
+    read(true);
+    _ready = true;
+  #endif
+  return true;
+}
+
+// Switch the reader to the sensor on another pin, possibly of another type.
+// The previous result is dropped and the next read may start right away.
+bool DHT::setSensor(uint8_t pin, uint8_t type) {
+  if (_state != DHT_IDLE) {
+    return false;
+  }
+  _pin = pin;
+  _type = type;
+  #ifdef __AVR
+    _bit = digitalPinToBitMask(pin);
+    _port = digitalPinToPort(pin);
+  #endif
+  _ready = false;
+  _lastresult = false;
+  _lastreadtime = millis() - MIN_INTERVAL;
+  pinMode(_pin, INPUT_PULLUP);
+  return true;
+}
+
+// Advance the asynchronous read, to be called on every iteration of loop().
+void DHT::update(void) {
+  #ifdef __AVR
+    uint32_t currenttime = millis();
+    if (_state == DHT_START && (currenttime - _statetime) >= START_SIGNAL) {
+      // Release the line and let the pin change interrupt decode every
+      // pulse sent by the sensor.
+      noInterrupts();
+      data[0] = data[1] = data[2] = data[3] = data[4] = 0;
+      _edges = 0;
+      _lowwidth = 0;
+      _pulseerror = false;
+      _active = this;
+      _state = DHT_CAPTURE;
+      enableInterrupt(true);
+      pinMode(_pin, INPUT_PULLUP);
+      interrupts();
+      _statetime = currenttime;
+    }
+    else if (_state == DHT_CAPTURE &&
+             (_edges > DHT_PULSES || (currenttime - _statetime) > CAPTURE_TIMEOUT)) {
+      // Capture complete or sensor silent, check what was received.
+      noInterrupts();
+      enableInterrupt(false);
+      _active = NULL;
+      interrupts();
+      _lastresult = decodePulses();
+      _state = DHT_IDLE;
+      _ready = true;
+    }
+  #endif
 }
 
+// Returns true once the asynchronous read has a result to collect.
+bool DHT::isReady(void) {
+  return _ready;
+}
+
+// Returns true while an asynchronous read is in progress.
+bool DHT::isBusy(void) {
+  return _state != DHT_IDLE;
+}
+
+// Check the bits decoded by the pin change interrupt: all the pulses must
+// have been received, none of them empty or longer than 255us.
+bool DHT::decodePulses(void) {
+  if ((_edges <= DHT_PULSES) || _pulseerror) {
+    DEBUG_PRINTLN(F("Timeout waiting for pulse."));
+    return false;
+  }
+  return checkData();
+}
+
+// Enable or disable the pin change interrupt of the data pin.
+void DHT::enableInterrupt(bool enable) {
+  #ifdef __AVR
+    if (enable) {
+      *digitalPinToPCMSK(_pin) |= _BV(digitalPinToPCMSKbit(_pin));
+      PCIFR = _BV(digitalPinToPCICRbit(_pin));
+      *digitalPinToPCICR(_pin) |= _BV(digitalPinToPCICRbit(_pin));
+    }
+    else {
+      *digitalPinToPCMSK(_pin) &= ~_BV(digitalPinToPCMSKbit(_pin));
+    }
+  #endif
+}
+
+// Pin change interrupt: time the pulse that just ended and decode it the same
+// way read() does. After the two response pulses, each bit is a low pulse,
+// whose width is kept, then a high pulse: the bit is a 1 when the high pulse
+// lasts longer than the 50us low pulse before it.
+// Edges are only counted from the first falling edge, i.e. once the sensor
+// starts its response, so that the release of the line is ignored.
+void DHT::handleInterrupt(void) {
+  #ifdef __AVR
+    DHT* dht = _active;
+    if (dht == NULL) {
+      return;
+    }
+    uint16_t now = micros();
+    uint8_t edges = dht->_edges;
+    if (edges == 0) {
+      if (*portInputRegister(dht->_port) & dht->_bit) {
+        return;
+      }
+    }
+    else if (edges <= DHT_PULSES) {
+      uint16_t elapsed = now - dht->_lastedge;
+      uint8_t width = elapsed > 0xFF ? 0xFF : elapsed;
+      if (edges >= 3) {
+        if ((width == 0) || (width == 0xFF)) {
+          dht->_pulseerror = true;
+        }
+        if (edges & 1) {
+          dht->_lowwidth = width;
+        }
+        else {
+          uint8_t i = (edges - 4) / 2;
+          dht->data[i/8] = (dht->data[i/8] << 1) | (width > dht->_lowwidth);
+        }
+      }
+    }
+    else {
+      return;
+    }
+    dht->_lastedge = now;
+    dht->_edges = edges + 1;
+  #endif
+}
+
+#ifdef __AVR
+#if defined(PCINT0_vect)
+ISR(PCINT0_vect) { DHT::handleInterrupt(); }
+#endif
+#if defined(PCINT1_vect)
+ISR(PCINT1_vect) { DHT::handleInterrupt(); }
+#endif
+#if defined(PCINT2_vect)
+ISR(PCINT2_vect) { DHT::handleInterrupt(); }
+#endif
+#if defined(PCINT3_vect)
+ISR(PCINT3_vect) { DHT::handleInterrupt(); }
+#endif
+#endif
+
 // Expect the signal line to be at the specified level for a period of time and
 // return a count of loop cycles spent at that level (this cycle count can be
 // used to compare the relative time of two pulses).  If more than a millisecond
@@ -234,8 +492,8 @@ boolean DHT::read(bool force) {
 // This is adapted from Arduino's pulseInLong function (which is only available
 // in the very latest IDE versions):
 //   https://github.com/arduino/Arduino/blob/master/hardware/arduino/avr/cores/arduino/wiring_pulse.c
-uint32_t DHT::expectPulse(bool level) {
-  uint32_t count = 0;
+uint16_t DHT::expectPulse(bool level) {
+  uint16_t count = 0;
   // On AVR platforms use direct GPIO port access as it's much faster and better
   // for catching pulses that are 10's of microseconds in length:
   #ifdef __AVR
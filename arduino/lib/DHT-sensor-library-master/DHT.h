@@ -34,6 +34,18 @@ written by Adafruit Industries
 #define DHT21 21
 #define AM2301 21
 
+// States of the asynchronous reader.
+#define DHT_IDLE 0
+#define DHT_START 1
+#define DHT_CAPTURE 2
+
+// Number of pulses timed by the asynchronous reader: the 80us low and
+// 80us high response followed by a low and a high pulse for each of the 40 bits.
+#define DHT_PULSES 82
+
+// Value returned by the fixed point getters when the last read failed.
+#define DHT_FIXED_INVALID INT16_MIN
+
 
 class DHT {
   public:
@@ -46,6 +58,34 @@ class DHT {
    float readHumidity(bool force=false);
    boolean read(bool force=false);
 
+   // Asynchronous reading: startRead() pulls the data line low and returns,
+   // update() must then be called from loop() to release the line while the
+   // pin change interrupt decodes each bit as it arrives. isReady() becomes
+   // true once a result is available, without ever blocking or masking
+   // interrupts during the capture.
+   bool startRead(bool force=false);
+
+   // Points the reader to another sensor, so that one reader serves several
+   // sensors in turn. Fails while a read is in progress.
+   bool setSensor(uint8_t pin, uint8_t type);
+   void update(void);
+   bool isReady(void);
+   bool isBusy(void);
+   float getTemperature(bool S=false);
+   float getHumidity(void);
+
+   // Integer variants of getTemperature() and getHumidity(), in 1/128 degree
+   // or percent (Q7 fixed point), DHT_FIXED_INVALID if the last read failed.
+   // They decode the integer bytes sent by the sensor without any float math.
+   int16_t getFixedTemperature(void);
+   int16_t getFixedHumidity(void);
+
+   // Raw 16 bit words sent by the sensor for the last read, before any
+   // conversion: integral byte then decimal byte.
+   uint16_t getRawTemperature(void);
+   uint16_t getRawHumidity(void);
+   static void handleInterrupt(void);
+
  private:
   uint8_t data[5];
   uint8_t _pin, _type;
@@ -54,10 +94,26 @@ class DHT {
     // for the digital pin connected to the DHT.  Other platforms will use digitalRead.
     uint8_t _bit, _port;
   #endif
-  uint32_t _lastreadtime, _maxcycles;
+  uint32_t _lastreadtime;
+  uint16_t _maxcycles;
   bool _lastresult;
 
-  uint32_t expectPulse(bool level);
+  // Asynchronous reader state, shared with the pin change interrupt which
+  // shifts the bits straight into data[]. Only the width of the last low
+  // pulse is kept, to be compared with the high pulse that follows it.
+  volatile uint8_t _state, _edges, _lowwidth;
+  volatile uint16_t _lastedge;
+  volatile bool _pulseerror;
+  uint32_t _statetime;
+  bool _ready;
+  static DHT* _active;
+
+  uint16_t expectPulse(bool level);
+  float convertTemperature(bool S);
+  float convertHumidity(void);
+  void enableInterrupt(bool enable);
+  bool decodePulses(void);
+  bool checkData(void);
 
 };
 
@@ -0,0 +1,114 @@
+/*
+		Fixed.cpp - Implémentation de la librairie de virgule fixe
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Un nombre en virgule fixe est un entier qui compte des fractions 1/2^shift de l'unité
+		Les mesures et les consignes sont en Q7 (shift = 7), les gains du PID en Q16: chaque méthode reçoit donc le format utilisé
+		Les nombres sont lus et écrits en décimal sans passer par les réels: l'AVR n'a pas d'unité de calcul flottant
+		et la moindre opération sur un float ajoute à la mémoire flash les routines de calcul flottant logiciel,
+		ainsi que dtostrf() et atof() pour les conversions en texte
+*/
+
+#include <ctype.h>
+#include <limits.h>
+#include <Fixed.h>
+
+// Méthode qui lit un nombre décimal, comme "-12", "22.5" ou ".25", et le convertit en virgule fixe
+// Seules les FIXED_MAX_DECIMALS premières décimales comptent, le résultat est arrondi à la fraction la plus proche
+// Une partie entière trop grande pour le format est saturée à sa valeur maximale
+//	- text: le texte à lire, les espaces en tête sont ignorés
+//	- end: reçoit l'adresse du premier caractère non lu, ou text si aucun chiffre n'a été trouvé (comme strtol), peut être NULL
+//	- shift: le nombre de bits de la partie fractionnaire
+//
+long Fixed::parse(const char* text, char** end, uint8_t shift){
+	const char* cursor = text;
+	while(*cursor == ' ') cursor++;
+	bool negative = *cursor == '-';
+	if(*cursor == '-' || *cursor == '+') cursor++;
+
+	// Partie entière
+	long limit = (LONG_MAX >> shift) - 1;
+	long whole = 0;
+	bool hasDigits = false;
+	while(isdigit(*cursor)){
+		whole = 10 * whole + (*cursor++ - '0');
+		if(whole > limit) whole = limit;
+		hasDigits = true;
+	}
+
+	// Partie décimale, comptée en 1/scale
+	long fraction = 0;
+	long scale = 1;
+	uint8_t decimals = 0;
+	if(*cursor == '.'){
+		cursor++;
+		while(isdigit(*cursor)){
+			if(decimals < FIXED_MAX_DECIMALS){
+				fraction = 10 * fraction + (*cursor - '0');
+				scale *= 10;
+				decimals++;
+			}
+			cursor++;
+			hasDigits = true;
+		}
+	}
+
+	if(!hasDigits){
+		if(end != NULL) *end = (char*)text;
+		return 0;
+	}
+	if(end != NULL) *end = (char*)cursor;
+	long value = (whole << shift) + ((fraction << shift) + scale / 2) / scale;
+	return negative ? -value : value;
+}
+
+// Méthode convertissant un nombre en virgule fixe en centièmes arrondis, le format des mesures envoyées au PC
+//	- value: le nombre à convertir
+//	- shift: le nombre de bits de sa partie fractionnaire
+//
+long Fixed::toHundredths(long value, uint8_t shift){
+	long hundredths = toDecimal(value < 0 ? -value : value, shift, 100);
+	return value < 0 ? -hundredths : hundredths;
+}
+
+// Méthode écrivant un nombre en virgule fixe en décimal, cadré à droite comme le fait dtostrf()
+// Le tampon doit pouvoir contenir FIXED_MAX_LENGTH caractères, ou width + 1 si c'est plus
+//	- buffer: le tampon qui reçoit le texte
+//	- value: le nombre à écrire
+//	- decimals: le nombre de chiffres après la virgule, au plus FIXED_MAX_DECIMALS, le dernier est arrondi
+//	- width: la largeur minimale du texte, complétée par des espaces à gauche
+//	- shift: le nombre de bits de la partie fractionnaire
+// Retourne le tampon
+//
+char* Fixed::format(char* buffer, long value, uint8_t decimals, uint8_t width, uint8_t shift){
+	unsigned long factor = 1;
+	for(uint8_t i = 0; i < decimals; i++) factor *= 10;
+	unsigned long digits = toDecimal(value < 0 ? -value : value, shift, factor);
+
+	// Les chiffres sont produits du dernier au premier, avec au moins un chiffre avant la virgule
+	char reversed[FIXED_MAX_LENGTH];
+	uint8_t length = 0;
+	uint8_t minimum = decimals > 0 ? decimals + 2 : 1;
+	bool negative = value < 0 && digits > 0;
+	do{
+		reversed[length++] = '0' + digits % 10;
+		digits /= 10;
+		if(decimals > 0 && length == decimals) reversed[length++] = '.';
+	} while(digits > 0 || length < minimum);
+	if(negative) reversed[length++] = '-';
+
+	uint8_t position = 0;
+	while(position + length < width) buffer[position++] = ' ';
+	while(length > 0) buffer[position++] = reversed[--length];
+	buffer[position] = '\0';
+	return buffer;
+}
+
+// Méthode privée convertissant la valeur absolue d'un nombre en virgule fixe en un nombre de 1/factor, arrondi
+// La partie entière et la partie fractionnaire sont converties séparément pour que le produit tienne sur 32 bits
+//
+unsigned long Fixed::toDecimal(unsigned long magnitude, uint8_t shift, unsigned long factor){
+	unsigned long fraction = magnitude & ((1UL << shift) - 1);
+	return (magnitude >> shift) * factor + ((fraction * factor + (1UL << shift) / 2) >> shift);
+}
@@ -0,0 +1,42 @@
+/*
+		Fixed.h - Librairie de lecture, de conversion et de formatage des nombres en virgule fixe
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+*/
+
+#ifndef Fixed_h
+#define Fixed_h
+
+#include <Arduino.h>
+
+// Format Q7 des mesures et des consignes: des 1/128 de degré ou de pour cent sur 16 bits signés, de -256 à +255,99
+// C'est l'unité brute de la sonde DS18B20, ses mesures n'ont donc aucune conversion à subir
+#define FIXED_SHIFT 7
+#define FIXED_ONE (1 << FIXED_SHIFT)
+
+// Valeur réservée à une mesure qui a échoué ou à une consigne pas encore reçue
+#define FIXED_INVALID INT16_MIN
+
+// Conversion d'une constante décimale en Q7, arrondie et calculée à la compilation
+#define FIXED(value) ((fixed_t)((value) * FIXED_ONE + ((value) < 0 ? -0.5 : 0.5)))
+
+// Nombre de décimales prises en compte par parse(), les suivantes sont lues mais ignorées
+#define FIXED_MAX_DECIMALS 4
+
+// Longueur maximale d'un nombre formaté par format(), zéro final compris et sans compter la largeur demandée
+#define FIXED_MAX_LENGTH 13
+
+typedef int16_t fixed_t;
+
+class Fixed{
+
+	public:
+		static long parse(const char* text, char** end, uint8_t shift = FIXED_SHIFT);
+		static long toHundredths(long value, uint8_t shift = FIXED_SHIFT);
+		static char* format(char* buffer, long value, uint8_t decimals, uint8_t width = 0, uint8_t shift = FIXED_SHIFT);
+
+	private:
+		static unsigned long toDecimal(unsigned long magnitude, uint8_t shift, unsigned long factor);
+};
+
+#endif
@@ -0,0 +1,97 @@
+/*
+		History.cpp - Implémentation de la librairie d'historique des mesures dans un tampon circulaire de taille fixe
+		Ecrit par Christophe BURY
+		Date de première release: 16/10/2026
+
+		Chaque mesure reçoit un numéro de séquence croissant (modulo 65536) qui permet au PC de détecter les trous
+		Un curseur désigne la prochaine mesure à envoyer: les mesures envoyées restent dans le tampon tant qu'elles
+		ne sont pas écrasées, le PC peut donc redemander une partie de l'historique après une coupure
+*/
+
+#include <History.h>
+
+// Constructeur de la classe History
+//
+History::History(){
+	head = 0;
+	count = 0;
+	nextSequence = 0;
+	cursor = 0;
+	dropped = 0;
+}
+
+// Méthode ajoutant une mesure à l'historique
+// Si le tampon est plein, la mesure la plus ancienne est écrasée; si elle n'avait pas encore été envoyée,
+// elle est comptée comme perdue et le curseur passe à la suivante
+//	- time: l'heure de la mesure
+//	- zone: la zone de l'unité où les valeurs ont été mesurées
+//	- airTemperature, airHumidity, waterTemperature: les valeurs mesurées, multipliées par 100
+//
+void History::push(unsigned long time, uint8_t zone, int16_t airTemperature, int16_t airHumidity, int16_t waterTemperature){
+	if(count == HISTORY_CAPACITY){
+		if(cursor == getOldestSequence()){
+			cursor++;
+			dropped++;
+		}
+	}
+	else count++;
+	Record* record = &records[head];
+	record->sequence = nextSequence++;
+	record->time = time;
+	record->zone = zone;
+	record->airTemperature = airTemperature;
+	record->airHumidity = airHumidity;
+	record->waterTemperature = waterTemperature;
+	head = (head + 1) % HISTORY_CAPACITY;
+}
+
+// Méthode retournant la prochaine mesure à envoyer et avançant le curseur
+// Retourne NULL si toutes les mesures ont été envoyées
+//
+const History::Record* History::nextPending(){
+	if(getPending() == 0) return NULL;
+	uint8_t index = (head + HISTORY_CAPACITY - getPending()) % HISTORY_CAPACITY;
+	cursor++;
+	return &records[index];
+}
+
+// Méthode replaçant le curseur sur une mesure déjà envoyée pour la renvoyer avec toutes les suivantes
+// Si la mesure demandée n'est plus dans le tampon, le curseur est placé sur la plus ancienne mesure conservée
+//	- sequence: le numéro de séquence de la première mesure à renvoyer
+// Retourne le numéro de séquence de la première mesure qui sera effectivement renvoyée
+//
+uint16_t History::rewind(uint16_t sequence){
+	if((uint16_t)(nextSequence - sequence) > count) cursor = getOldestSequence();
+	else cursor = sequence;
+	return cursor;
+}
+
+// Méthode retournant le nombre de mesures pas encore envoyées
+//
+uint8_t History::getPending(){
+	return nextSequence - cursor;
+}
+
+// Méthode retournant le nombre de mesures conservées dans le tampon
+//
+uint8_t History::getCount(){
+	return count;
+}
+
+// Méthode retournant le numéro de séquence de la prochaine mesure
+//
+uint16_t History::getNextSequence(){
+	return nextSequence;
+}
+
+// Méthode retournant le nombre de mesures écrasées avant d'avoir été envoyées
+//
+unsigned int History::getDropped(){
+	return dropped;
+}
+
+// Méthode retournant le numéro de séquence de la plus ancienne mesure conservée
+//
+uint16_t History::getOldestSequence(){
+	return nextSequence - count;
+}
@@ -0,0 +1,50 @@
+/*
+		History.h - Librairie d'historique des mesures dans un tampon circulaire de taille fixe
+		Ecrit par Christophe BURY
+		Date de première release: 16/10/2026
+*/
+
+#ifndef History_h
+#define History_h
+
+#include <Arduino.h>
+
+// Nombre maximal de mesures conservées, les plus anciennes sont écrasées au-delà
+#ifndef HISTORY_CAPACITY
+#define HISTORY_CAPACITY 24
+#endif
+
+class History{
+
+	public:
+		typedef struct{
+			uint16_t sequence;
+			unsigned long time;
+			uint8_t zone;
+			int16_t airTemperature;
+			int16_t airHumidity;
+			int16_t waterTemperature;
+		} Record;
+
+		History();
+
+		void push(unsigned long time, uint8_t zone, int16_t airTemperature, int16_t airHumidity, int16_t waterTemperature);
+		const Record* nextPending();
+		uint16_t rewind(uint16_t sequence);
+		uint8_t getPending();
+		uint8_t getCount();
+		uint16_t getNextSequence();
+		unsigned int getDropped();
+
+	private:
+		Record records[HISTORY_CAPACITY];
+		uint8_t head;
+		uint8_t count;
+		uint16_t nextSequence;
+		uint16_t cursor;
+		unsigned int dropped;
+
+		uint16_t getOldestSequence();
+};
+
+#endif
@@ -4,11 +4,20 @@
 		Date de première release: 24/02/2017	
 
 		L'écran LCD M18ST05A est de type communication série, dans le principe, une broche TX est suffisante pour le piloter
-		Le choix a été fait d'utiliser la librairie SoftwareSerial pour la communication afin de libérer les pins TX/RX
+		La communication passe par la liaison LCDSerial, en émission seule, afin de libérer les pins TX/RX
+		Les octets sont mis en file d'attente et envoyés bit par bit sous interruption du Timer1, sans bloquer la boucle principale
+
+		La classe garde une copie (shadow) de ce qui est affiché sur chacune des deux lignes
+		Une ligne n'est renvoyée que si elle a changé, et de la façon la moins coûteuse en octets parmi:
+			- continuer à écrire à la position actuelle du curseur, si celui-ci est avant la première cellule modifiée
+			- sélectionner la ligne (le curseur revient en colonne 0) et réécrire jusqu'à la dernière cellule modifiée
+			- effacer la ligne et réécrire jusqu'au dernier caractère non blanc, comme le faisait la version précédente
+		Le M18ST05A n'ayant pas de commande de positionnement en colonne, les cellules qui précèdent une modification
+		doivent être réécrites quand le curseur n'est pas déjà devant elles
 */
 
 #include <Time.h>
-#include <SoftwareSerial.h>
+#include <LCDSerial.h>
 #include <LCD.h>
 
 // Définition des codes pour caractères spéciaux
@@ -69,6 +78,7 @@ const char LCD::FRAME_MEDIAS = 0X25;
 const char LCD::FRAME_VCR = 0X26;
 const char LCD::FRAME_MAIL = 0X27;
 
+void begin();																							// Prépare les broches de l'écran et le Timer1 de sa liaison série
 void clearDisplay(char lines);														// Permet d'effacer une ligne au choix ou les deux lignes de l'écran LCD
 void displayAt(const char* text, char line, int column);	// Permet d'afficher du texte sur une ligne et une colonne précises
 void displayCenter(const char* text, char line);					// Permet d'afficher du texte centré sur une ligne
@@ -79,18 +89,40 @@ void setClock();																					// Permet de régler la date et l'heure de
 void clockFormat(char format);														// Permet de sélectionner le type d'affichage de l'horloge
 void cdSpeed(char speed);																	// Permet de définir la vitesse de rotation de l'icône CD
 void recSpeed(char speed);																// Permet de définir la vitesse de clignotement de l'icône d'enregistrement
+uint8_t getQueueHighWater();															// Retourne la plus grande profondeur atteinte par la file d'attente
+void resetQueueHighWater();																// Remet à zéro la plus grande profondeur de la file d'attente
+bool isIdle();																						// Retourne true quand aucun octet n'est en cours d'envoi
+long getBytesSaved();																			// Retourne le nombre d'octets économisés par rapport à un effacement et une réécriture complète
+void resetBytesSaved();																		// Remet à zéro le nombre d'octets économisés
+void updateLine(uint8_t index, const char* content, unsigned int reference);	// Met à jour une ligne de l'écran en n'envoyant que ce qui a changé
+void invalidate();																				// Oublie le contenu de l'écran, après l'affichage de l'horloge par exemple
+int8_t lineIndex(char line);															// Convertit une sélection de ligne en numéro de ligne
 uint8_t int2BCD(int number);															// Convertit un nombre à deux chiffres au format BCD
 
 // Constructeur de la classe LCD
-// Les paramètres d'initialisation permettent de définir les broches RX et TX utilisées par la librairie SoftwareSerial
+// Les paramètres d'initialisation permettent de définir les broches RX et TX de l'écran
+// Le constructeur n'écrit dans aucun registre: un objet global est construit avant init() du noyau Arduino,
+// qui reconfigure ensuite les timers. Le matériel n'est préparé que par begin(), à appeler depuis setup()
 //
 LCD::LCD(uint8_t rx, uint8_t tx){
 
-	// On initialise le software serial sur les pins rx et tx pour piloter l'écran LCD
-	lcd = new SoftwareSerial(rx, tx);
-	pinMode(rx, INPUT);
-	pinMode(tx, OUTPUT);
-	lcd->begin(9600);
+	// On prépare la liaison série en émission seule sur la pin tx pour piloter l'écran LCD
+	lcd = new LCDSerial(tx);
+	rxPin = rx;
+	txPin = tx;
+
+	// Au démarrage, on ne sait pas ce qui est affiché
+	invalidate();
+	bytesSaved = 0;
+}
+
+// Méthode préparant les broches de l'écran et le Timer1 qui cadence la liaison série
+// L'écran ne renvoyant rien, la broche RX est seulement placée en entrée
+//
+void LCD::begin(){
+	pinMode(rxPin, INPUT);
+	pinMode(txPin, OUTPUT);
+	lcd->begin(LCD_SPEED);
 }
 
 // Méthode permettant l'effacement d'une ligne ou de la totalité de l'écran
@@ -104,6 +136,15 @@ void LCD::clearDisplay(char line){
 	lcd->write(line);
 	lcd->write(0x1b);
 	lcd->write(0x50);
+	int8_t index = lineIndex(line);
+	for(uint8_t i = 0; i < LCD_LINES; i++){
+		if(index < 0 || index == i){
+			memset(shadow[i], ' ', LCD_COLUMNS);
+			shadowValid[i] = true;
+		}
+	}
+	cursorLine = index;
+	cursorColumn = 0;
 }
 
 // Méthode affichant une ligne de texte sur la ligne et à la colonne sélectionnées
@@ -112,14 +153,37 @@ void LCD::clearDisplay(char line){
 //	- column: la colonne à partir de laquelle le texte est affiché (0 est la première colonne, 15 la dernière)
 //
 void LCD::displayAt(const char* text, char line, int column){
-	clearDisplay(line);
-	char charArray[17] = "";
-	char formatter[5] = "";
-	if(column < 16){
-		snprintf(formatter, 5, "%%%ds", (unsigned)strlen(text) + column);
-		snprintf(charArray, 17, formatter, text);
-		lcd->print(charArray);
+	int8_t index = lineIndex(line);
+
+	// Sans ligne précise, on garde l'ancien comportement: effacement et réécriture complète
+	if(index < 0){
+		clearDisplay(line);
+		char charArray[17] = "";
+		char formatter[5] = "";
+		if(column < 16){
+			snprintf_P(formatter, 5, PSTR("%%%ds"), (unsigned)strlen(text) + column);
+			snprintf(charArray, 17, formatter, text);
+			lcd->print(charArray);
+		}
+		invalidate();
+		return;
 	}
+
+	// On prépare le contenu complet de la ligne, complété par des blancs
+	char content[LCD_COLUMNS];
+	memset(content, ' ', LCD_COLUMNS);
+	uint8_t end = column;
+	if(column < LCD_COLUMNS){
+		uint8_t length = min(strlen(text), (size_t)(LCD_COLUMNS - column));
+		memcpy(content + column, text, length);
+		end = column + length;
+	}
+	else end = LCD_COLUMNS;
+
+	// La version précédente effaçait la ligne (4 octets) puis envoyait le texte précédé de ses blancs
+	updateLine(index, content, column < LCD_COLUMNS ? 4 + end : 4);
+	textLine = index;
+	textColumn = end;
 }
 
 // Méthode affichant une ligne de texte au centre de la ligne sélectionnée
@@ -133,12 +197,52 @@ void LCD::displayCenter(const char* text, char line){
 	displayAt(text, line, pos);
 }
 
+// Méthodes affichant un texte conservé en mémoire flash, déclaré avec F("...")
+// Le texte est recopié dans un tampon d'une ligne sur la pile, il ne réside jamais en SRAM
+//
+void LCD::displayAt(const __FlashStringHelper* text, char line, int column){
+	char buffer[LCD_COLUMNS + 1];
+	strncpy_P(buffer, (PGM_P)text, LCD_COLUMNS);
+	buffer[LCD_COLUMNS] = '\0';
+	displayAt(buffer, line, column);
+}
+
+void LCD::displayCenter(const __FlashStringHelper* text, char line){
+	char buffer[LCD_COLUMNS + 1];
+	strncpy_P(buffer, (PGM_P)text, LCD_COLUMNS);
+	buffer[LCD_COLUMNS] = '\0';
+	displayCenter(buffer, line);
+}
+
+void LCD::displayAfter(const __FlashStringHelper* text){
+	char buffer[LCD_COLUMNS + 1];
+	strncpy_P(buffer, (PGM_P)text, LCD_COLUMNS);
+	buffer[LCD_COLUMNS] = '\0';
+	displayAfter(buffer);
+}
+
 // Méthode affichant du texte à partir de la postion actuelle du curseur
 // Le curseur est positionné à la colonne juste après le dernier caractère affiché
 //	- text: la ligne à afficher
 //
 void LCD::displayAfter(const char* text){
-	lcd->print(text);
+
+	// Sans affichage précédent, on ne sait pas où se trouve le texte: on écrit directement
+	if(textLine < 0){
+		lcd->print(text);
+		invalidate();
+		return;
+	}
+
+	// Le texte est ajouté au contenu actuel de la ligne, après le dernier texte affiché
+	char content[LCD_COLUMNS];
+	memcpy(content, shadow[textLine], LCD_COLUMNS);
+	uint8_t length = min(strlen(text), (size_t)(LCD_COLUMNS - textColumn));
+	memcpy(content + textColumn, text, length);
+
+	// La version précédente envoyait seulement le texte
+	updateLine(textLine, content, strlen(text));
+	textColumn += length;
 }
 
 // Méthode permettant d'allumer ou d'éteindre une icône sous les deux lignes d'affichage
@@ -157,6 +261,7 @@ void LCD::displayIcon(char icon, char level){
 void LCD::displayClock(){
 	lcd->write(0x1b);
 	lcd->write(0x05);
+	invalidate();
 }
 
 // Méthode permettent d'ajuster l'horloge interne du LCD
@@ -172,6 +277,7 @@ void LCD::setClock(){
 	lcd->write(int2BCD(month(currentTime)));
 	lcd->write(int2BCD(year(currentTime) / 100));
 	lcd->write(int2BCD(year(currentTime) % 100));
+	invalidate();
 }
 
 // Méthode permettant de définir la façon d'afficher l'horloge
@@ -180,6 +286,7 @@ void LCD::setClock(){
 void LCD::clockFormat(char format){
 	lcd->write(0x1b);
 	lcd->write(format);
+	invalidate();
 }
 
 // Méthode permettant de sélectionner la vitesse de rotation de l'icône CD
@@ -200,6 +307,123 @@ void LCD::recSpeed(char speed){
 	lcd->write(speed);
 }
 
+// Méthode retournant la plus grande profondeur atteinte par la file d'attente depuis la dernière remise à zéro
+//
+uint8_t LCD::getQueueHighWater(){
+	return lcd->getHighWater();
+}
+
+// Méthode remettant à zéro la plus grande profondeur atteinte par la file d'attente
+//
+void LCD::resetQueueHighWater(){
+	lcd->resetHighWater();
+}
+
+// Méthode suspendant (isHeld à true) ou reprenant l'envoi des octets en attente vers l'écran
+// Les affichages demandés pendant la suspension sont mis en file et partent à la reprise
+//
+void LCD::hold(bool isHeld){
+	lcd->hold(isHeld);
+}
+
+// Méthode retournant true quand aucun octet n'est en cours d'envoi vers l'écran
+// Suspendu par hold(), l'envoi devient inactif à la fin de l'octet en cours
+//
+bool LCD::isIdle(){
+	return lcd->isIdle();
+}
+
+// Méthode retournant le nombre d'octets économisés depuis la dernière remise à zéro
+// par rapport à la version précédente qui effaçait et réécrivait toute la ligne à chaque affichage
+//
+long LCD::getBytesSaved(){
+	return bytesSaved;
+}
+
+// Méthode remettant à zéro le nombre d'octets économisés
+//
+void LCD::resetBytesSaved(){
+	bytesSaved = 0;
+}
+
+// Méthode privée mettant à jour une ligne de l'écran à partir de son contenu complet
+// Seules les cellules modifiées sont envoyées, par le moyen le moins coûteux (voir l'en-tête du fichier)
+//	- index: le numéro de la ligne (0 pour la ligne supérieure, 1 pour la ligne inférieure)
+//	- content: les LCD_COLUMNS caractères de la ligne
+//	- reference: le nombre d'octets qu'aurait envoyé la version précédente, pour le calcul de l'économie
+//
+void LCD::updateLine(uint8_t index, const char* content, unsigned int reference){
+
+	// Recherche des première et dernière cellules modifiées, et du dernier caractère non blanc
+	int8_t first = 0;
+	int8_t last = LCD_COLUMNS - 1;
+	if(shadowValid[index]){
+		while(first < LCD_COLUMNS && content[first] == shadow[index][first]) first++;
+		while(last >= first && content[last] == shadow[index][last]) last--;
+	}
+	int8_t lastText = LCD_COLUMNS - 1;
+	while(lastText >= 0 && content[lastText] == ' ') lastText--;
+
+	// Calcul du coût de chaque méthode de mise à jour
+	unsigned int sent = 0;
+	if(first <= last){
+		unsigned int costFull = 4 + lastText + 1;
+		unsigned int costSelect = shadowValid[index] ? 2 + last + 1 : 0xFFFF;
+		unsigned int costCursor = shadowValid[index] && cursorLine == index && cursorColumn <= first ? last + 1 - cursorColumn : 0xFFFF;
+		uint8_t from = 0;
+		uint8_t to;
+
+		// On continue à écrire à la position du curseur
+		if(costCursor <= costSelect && costCursor <= costFull){
+			from = cursorColumn;
+			to = last + 1;
+			sent = costCursor;
+		}
+
+		// On sélectionne la ligne pour ramener le curseur en colonne 0
+		else if(costSelect <= costFull){
+			lcd->write(0x1b);
+			lcd->write(index == 0 ? DISPLAY_TOP : DISPLAY_BOTTOM);
+			to = last + 1;
+			sent = costSelect;
+		}
+
+		// On efface la ligne
+		else{
+			lcd->write(0x1b);
+			lcd->write(index == 0 ? DISPLAY_TOP : DISPLAY_BOTTOM);
+			lcd->write(0x1b);
+			lcd->write(0x50);
+			to = lastText + 1;
+			sent = costFull;
+		}
+		for(uint8_t i = from; i < to; i++) lcd->write(content[i]);
+		cursorLine = to < LCD_COLUMNS ? index : -1;
+		cursorColumn = to;
+		memcpy(shadow[index], content, LCD_COLUMNS);
+		shadowValid[index] = true;
+	}
+	bytesSaved += (long)reference - sent;
+}
+
+// Méthode privée oubliant le contenu de l'écran et la position du curseur
+// Elle est appelée après une commande qui remplace l'affichage des lignes, comme l'horloge
+//
+void LCD::invalidate(){
+	for(uint8_t i = 0; i < LCD_LINES; i++) shadowValid[i] = false;
+	cursorLine = -1;
+	textLine = -1;
+}
+
+// Méthode privée convertissant une sélection de ligne (DISPLAY_TOP, DISPLAY_BOTTOM) en numéro de ligne
+// Retourne -1 pour DISPLAY_BOTH
+//
+int8_t LCD::lineIndex(char line){
+	if(line == DISPLAY_TOP) return 0;
+	if(line == DISPLAY_BOTTOM) return 1;
+	return -1;
+}
+
 // Méthode privée permettant de convertir un nombre de deux chiffres au format BCD
 //	- number: le nombre à convertir
 //
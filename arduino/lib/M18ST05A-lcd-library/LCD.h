@@ -9,7 +9,14 @@
 
 #include <Arduino.h>
 #include <Time.h>
-#include <SoftwareSerial.h>
+#include <LCDSerial.h>
+
+// Dimensions de l'écran M18ST05A
+#define LCD_LINES 2
+#define LCD_COLUMNS 16
+
+// Vitesse de la liaison série de l'écran M18ST05A
+#define LCD_SPEED 9600
 
 class LCD{
 
@@ -61,19 +68,41 @@ class LCD{
 
 		LCD(uint8_t rx, uint8_t tx);
 
+		void begin();
 		void clearDisplay(char lines);
 		void displayAt(const char* text, char line, int column);
 		void displayCenter(const char* text, char line);
 		void displayAfter(const char* text);
+		void displayAt(const __FlashStringHelper* text, char line, int column);
+		void displayCenter(const __FlashStringHelper* text, char line);
+		void displayAfter(const __FlashStringHelper* text);
 		void displayIcon(char icon, char level);
 		void displayClock();
 		void setClock();
 		void clockFormat(char format);
 		void cdSpeed(char speed);
 		void recSpeed(char speed);
+		uint8_t getQueueHighWater();
+		void resetQueueHighWater();
+		void hold(bool isHeld);
+		bool isIdle();
+		long getBytesSaved();
+		void resetBytesSaved();
 
 	private:
-		SoftwareSerial* lcd;
+		LCDSerial* lcd;
+		uint8_t rxPin;
+		uint8_t txPin;
+		char shadow[LCD_LINES][LCD_COLUMNS];
+		bool shadowValid[LCD_LINES];
+		int8_t cursorLine;
+		uint8_t cursorColumn;
+		int8_t textLine;
+		uint8_t textColumn;
+		long bytesSaved;
+		void updateLine(uint8_t index, const char* content, unsigned int reference);
+		void invalidate();
+		static int8_t lineIndex(char line);
 		uint8_t int2BCD(int number);
 };
 
@@ -0,0 +1,212 @@
+/*
+		LCDSerial.cpp - Implémentation de la liaison série en émission seule utilisée pour piloter l'écran LCD M18ST05A
+		Ecrit par Christophe BURY
+		Date de première release: 16/10/2026
+
+		L'écran M18ST05A ne renvoie jamais rien, seule la broche TX est nécessaire pour le piloter
+		Contrairement à SoftwareSerial, cette liaison ne réserve donc aucune interruption de changement d'état des broches,
+		ce qui laisse les vecteurs PCINT libres pour la lecture asynchrone du capteur DHT
+
+		Les octets écrits sont placés dans une file d'attente circulaire et l'appel revient immédiatement
+		Sur AVR, la file est vidée par l'interruption de débordement du Timer1, qui déborde une fois par durée de bit:
+		chaque interruption positionne un seul bit sur la broche et rend la main. Les interruptions ne sont jamais masquées
+		pendant l'envoi, la réception du port série matériel à 115200 bauds n'est donc jamais retardée de plus de quelques cycles
+
+		Le Timer1 est passé en mode Fast PWM avec ICR1 comme valeur maximale (mode 14)
+		Les sorties PWM des broches 9 et 10 restent utilisables avec analogWrite(), mais leur rapport cyclique
+		s'exprime alors sur LCD_TIMER_TOP(speed) et non plus sur 255
+		L'interruption n'est activée que lorsque la file contient des octets
+*/
+
+#include <LCDSerial.h>
+
+LCDSerial* LCDSerial::active = NULL;
+
+// Constructeur de la classe LCDSerial
+// Le paramètre tx définit la broche utilisée pour l'émission
+//
+LCDSerial::LCDSerial(uint8_t tx){
+	txPin = tx;
+	head = 0;
+	tail = 0;
+	highWater = 0;
+	isHeld = false;
+	bitCount = 0;
+	#ifdef __AVR
+		txPort = portOutputRegister(digitalPinToPort(tx));
+		txBit = digitalPinToBitMask(tx);
+	#endif
+}
+
+// Méthode préparant la broche d'émission et le cadencement des bits
+//	- speed: la vitesse de communication en bauds
+//
+void LCDSerial::begin(long speed){
+	pinMode(txPin, OUTPUT);
+	writeBit(HIGH);
+	#ifdef __AVR
+
+		// Mode 14 (WGM13..WGM10 = 1110) en conservant les sorties PWM déjà activées par analogWrite()
+		uint8_t oldSREG = SREG;
+		noInterrupts();
+		active = this;
+		TCCR1A = (TCCR1A & (_BV(COM1A1) | _BV(COM1A0) | _BV(COM1B1) | _BV(COM1B0))) | _BV(WGM11);
+		TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS11);
+		ICR1 = LCD_TIMER_TOP(speed);
+		TIMSK1 &= ~_BV(TOIE1);
+		SREG = oldSREG;
+	#else
+		bitDelay = 1000000L / speed;
+	#endif
+}
+
+// Méthode plaçant un octet dans la file d'attente d'envoi
+// Si la file est pleine, on attend que l'interruption ait envoyé l'octet le plus ancien pour ne jamais perdre une séquence de commande
+// Une file pleine lève la suspension de l'envoi, sans quoi l'attente ne finirait jamais
+//	- byte: l'octet à envoyer
+//
+size_t LCDSerial::write(uint8_t byte){
+	#ifdef __AVR
+		uint8_t next = (head + 1) % LCD_QUEUE_SIZE;
+		if(next == tail) hold(false);
+		while(next == tail);
+		queue[head] = byte;
+		head = next;
+		uint8_t queued = getQueued();
+		if(queued > highWater) highWater = queued;
+
+		// On (ré)active l'interruption, sans effet si un envoi est déjà en cours ou suspendu
+		if(!isHeld) startSending();
+	#else
+		send(byte);
+	#endif
+	return 1;
+}
+
+// Méthode retournant le nombre d'octets en attente d'envoi
+//
+uint8_t LCDSerial::getQueued(){
+	return (head + LCD_QUEUE_SIZE - tail) % LCD_QUEUE_SIZE;
+}
+
+// Méthode retournant le plus grand nombre d'octets en attente atteint depuis la dernière remise à zéro
+//
+uint8_t LCDSerial::getHighWater(){
+	return highWater;
+}
+
+// Méthode remettant à zéro le plus grand nombre d'octets en attente
+//
+void LCDSerial::resetHighWater(){
+	highWater = getQueued();
+}
+
+// Méthode suspendant ou reprenant l'envoi, sans rien perdre de la file
+// Suspendu, l'envoi termine l'octet en cours puis s'arrête entre deux octets: le Timer1 n'interrompt plus le programme,
+// ce qui laisse les interruptions de changement d'état de la capture du capteur DHT servies sans retard
+//	- isHeld: true pour suspendre l'envoi, false pour le reprendre
+//
+void LCDSerial::hold(bool isHeld){
+	if(isHeld == this->isHeld) return;
+	this->isHeld = isHeld;
+	if(!isHeld && head != tail) startSending();
+}
+
+// Méthode retournant true quand aucun octet n'est en cours d'envoi: l'interruption du Timer1 est alors désactivée,
+// ce qui n'arrive qu'à la fin d'un bit de stop
+//
+bool LCDSerial::isIdle(){
+	#ifdef __AVR
+		return !(TIMSK1 & _BV(TOIE1));
+	#else
+		return true;
+	#endif
+}
+
+// Méthode statique appelée par l'interruption de débordement du Timer1, une fois par durée de bit
+//
+void LCDSerial::handleInterrupt(){
+	LCDSerial* serial = active;
+	if(serial != NULL) serial->nextBit();
+}
+
+// Méthode privée activant l'interruption de débordement du Timer1 si elle ne l'est pas déjà
+// Le Timer1 tourne en permanence: après une attente de plus d'une durée de bit, son indicateur de débordement TOV1
+// est déjà levé et l'interruption partirait aussitôt, au milieu d'une période. On efface donc l'indicateur avant
+// d'activer l'interruption, dans une même section atomique, pour que le bit de start commence au débordement suivant
+// et dure une période complète
+//
+void LCDSerial::startSending(){
+	#ifdef __AVR
+		uint8_t oldSREG = SREG;
+		noInterrupts();
+		if(!(TIMSK1 & _BV(TOIE1))){
+			TIFR1 = _BV(TOV1);
+			TIMSK1 |= _BV(TOIE1);
+		}
+		SREG = oldSREG;
+	#endif
+}
+
+// Méthode privée positionnant le bit suivant de l'octet en cours d'envoi
+// bitCount vaut 0 entre deux octets, 1 à 8 pendant les bits de données (poids faible en premier) et 9 pendant le bit de stop
+// Quand la file est vide ou l'envoi suspendu à la fin d'un bit de stop, l'interruption est désactivée
+// jusqu'au prochain write() ou jusqu'à la reprise de l'envoi
+//
+void LCDSerial::nextBit(){
+	#ifdef __AVR
+		if(bitCount == 0){
+			if(head == tail || isHeld){
+				TIMSK1 &= ~_BV(TOIE1);
+				return;
+			}
+			current = queue[tail];
+			tail = (tail + 1) % LCD_QUEUE_SIZE;
+			writeBit(LOW);
+			bitCount = 1;
+		}
+		else if(bitCount <= 8){
+			writeBit(current & 0x01);
+			current >>= 1;
+			bitCount++;
+		}
+		else{
+			writeBit(HIGH);
+			bitCount = 0;
+		}
+	#endif
+}
+
+// Méthode privée envoyant directement un octet, utilisée hors AVR où le Timer1 n'existe pas
+// (un bit de start, huit bits de données en commençant par le poids faible et un bit de stop)
+//	- byte: l'octet à envoyer
+//
+#ifndef __AVR
+void LCDSerial::send(uint8_t byte){
+	writeBit(LOW);
+	delayMicroseconds(bitDelay);
+	for(uint8_t mask = 0x01; mask; mask <<= 1){
+		writeBit(byte & mask ? HIGH : LOW);
+		delayMicroseconds(bitDelay);
+	}
+	writeBit(HIGH);
+	delayMicroseconds(bitDelay);
+}
+#endif
+
+// Méthode privée positionnant la broche d'émission
+// Sur AVR, on écrit directement dans le registre du port pour que la durée des bits ne dépende pas de digitalWrite
+//	- level: HIGH ou LOW
+//
+void LCDSerial::writeBit(uint8_t level){
+	#ifdef __AVR
+		if(level) *txPort |= txBit;
+		else *txPort &= ~txBit;
+	#else
+		digitalWrite(txPin, level);
+	#endif
+}
+
+#ifdef __AVR
+ISR(TIMER1_OVF_vect) { LCDSerial::handleInterrupt(); }
+#endif
@@ -0,0 +1,62 @@
+/*
+		LCDSerial.h - Liaison série en émission seule utilisée pour piloter l'écran LCD M18ST05A
+		Ecrit par Christophe BURY
+		Date de première release: 16/10/2026
+*/
+
+#ifndef LCDSerial_h
+#define LCDSerial_h
+
+#include <Arduino.h>
+
+// Taille de la file d'attente des octets à envoyer à l'écran
+// Une page complète (effacement et 16 caractères sur chacune des deux lignes) tient dans la file
+#ifndef LCD_QUEUE_SIZE
+#define LCD_QUEUE_SIZE 64
+#endif
+
+// Pré-diviseur du Timer1 et valeur maximale du compteur pour qu'un débordement corresponde à la durée d'un bit
+// A 16 MHz et 9600 bauds, le compteur va de 0 à 207 (9615 bauds, soit 0,2% d'écart)
+#define LCD_TIMER_PRESCALER 8
+#define LCD_TIMER_TOP(speed) (F_CPU / LCD_TIMER_PRESCALER / (speed) - 1)
+
+class LCDSerial : public Print{
+
+	public:
+		LCDSerial(uint8_t tx);
+
+		void begin(long speed);
+		virtual size_t write(uint8_t byte);
+		using Print::write;
+		uint8_t getQueued();
+		uint8_t getHighWater();
+		void resetHighWater();
+		void hold(bool isHeld);
+		bool isIdle();
+		static void handleInterrupt();
+
+	private:
+		static LCDSerial* active;
+		uint8_t txPin;
+		#ifdef __AVR
+			volatile uint8_t* txPort;
+			uint8_t txBit;
+		#else
+			unsigned int bitDelay;
+		#endif
+		uint8_t queue[LCD_QUEUE_SIZE];
+		volatile uint8_t head;
+		volatile uint8_t tail;
+		uint8_t highWater;
+		volatile bool isHeld;
+		uint8_t current;
+		uint8_t bitCount;
+		void nextBit();
+		void startSending();
+		#ifndef __AVR
+			void send(uint8_t byte);
+		#endif
+		void writeBit(uint8_t level);
+};
+
+#endif
@@ -0,0 +1,116 @@
+/*
+		Memory.cpp - Implémentation de la librairie de surveillance de la mémoire SRAM
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		La SRAM de l'ATmega328 contient, de bas en haut: les variables globales, le tas qui monte et la pile qui descend
+		Avant même l'initialisation des variables, toute la zone comprise entre la fin des variables et le sommet de la pile
+		est remplie par MEMORY_CANARY: les octets qui portent encore ce motif n'ont jamais été touchés
+		La marge de la pile est le nombre de ces octets au-dessus du tas: c'est ce qui a séparé la pile du tas au pire moment
+		depuis le démarrage, et ce qui reste avant un plantage silencieux
+		Les blocs libérés par free() forment la liste des blocs libres de l'avr-libc, que l'on parcourt pour mesurer
+		la fragmentation du tas: un tas morcelé a beaucoup de place libre mais pas de grand bloc
+
+		Hors AVR (exécution native), il n'y a rien à mesurer et toutes les valeurs sont nulles
+*/
+
+#include <Memory.h>
+
+#ifdef __AVR
+
+// Symboles de l'éditeur de liens et de l'avr-libc: fin des variables, sommet de la SRAM,
+// fin du tas et liste des blocs libres
+extern uint8_t _end;
+extern uint8_t __stack;
+extern char* __brkval;
+
+struct __freelist{
+	size_t sz;
+	struct __freelist* nx;
+};
+extern struct __freelist* __flp;
+
+// Procédure qui remplit la mémoire libre avec MEMORY_CANARY
+// Placée dans la section .init1, elle s'exécute avant l'initialisation des variables et de la pile:
+// elle est donc écrite en assembleur, sans appel et sans utiliser la pile
+//
+void paintStack() __attribute__((naked, used, section(".init1")));
+void paintStack(){
+	__asm volatile(
+		"	ldi r30, lo8(_end)\n"
+		"	ldi r31, hi8(_end)\n"
+		"	ldi r24, %0\n"
+		"	ldi r25, hi8(__stack)\n"
+		"	rjmp 2f\n"
+		"1:\n"
+		"	st Z+, r24\n"
+		"2:\n"
+		"	cpi r30, lo8(__stack)\n"
+		"	cpc r31, r25\n"
+		"	brlo 1b\n"
+		"	breq 1b\n"
+		:: "M" (MEMORY_CANARY));
+}
+
+// Fonction qui retourne l'adresse de la fin du tas
+//
+static uint8_t* heapEnd(){
+	return __brkval == NULL ? &_end : (uint8_t*)__brkval;
+}
+
+#endif
+
+// Méthode retournant la mémoire libre: l'espace entre le tas et la pile et les blocs libres du tas
+//
+unsigned int Memory::getFree(){
+	#ifdef __AVR
+		uint8_t top;
+		return (unsigned int)(&top - heapEnd()) + getHeapFree();
+	#else
+		return 0;
+	#endif
+}
+
+// Méthode retournant le nombre d'octets jamais atteints par la pile depuis le démarrage, juste au-dessus du tas
+// On compte les octets qui portent encore MEMORY_CANARY en partant de la fin du tas
+//
+unsigned int Memory::getStackMargin(){
+	#ifdef __AVR
+		uint8_t* p = heapEnd();
+		unsigned int margin = 0;
+		while(p <= &__stack && *p == MEMORY_CANARY){
+			p++;
+			margin++;
+		}
+		return margin;
+	#else
+		return 0;
+	#endif
+}
+
+// Méthode retournant la somme des blocs de la liste des blocs libres du tas, en-têtes compris
+//
+unsigned int Memory::getHeapFree(){
+	#ifdef __AVR
+		unsigned int total = 0;
+		for(struct __freelist* block = __flp; block != NULL; block = block->nx) total += block->sz + sizeof(size_t);
+		return total;
+	#else
+		return 0;
+	#endif
+}
+
+// Méthode retournant la taille du plus grand bloc de la liste des blocs libres du tas
+// Comparé à getHeapFree(), il mesure la fragmentation: une allocation plus grande devra être prise au-dessus du tas
+//
+unsigned int Memory::getHeapLargest(){
+	#ifdef __AVR
+		unsigned int largest = 0;
+		for(struct __freelist* block = __flp; block != NULL; block = block->nx){
+			if(block->sz > largest) largest = block->sz;
+		}
+		return largest;
+	#else
+		return 0;
+	#endif
+}
@@ -0,0 +1,24 @@
+/*
+		Memory.h - Librairie de surveillance de la mémoire SRAM: pile, tas et mémoire libre
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+*/
+
+#ifndef Memory_h
+#define Memory_h
+
+#include <Arduino.h>
+
+// Motif écrit au démarrage dans toute la mémoire libre, entre la fin du tas et le sommet de la pile
+#define MEMORY_CANARY 0xC5
+
+class Memory{
+
+	public:
+		static unsigned int getFree();
+		static unsigned int getStackMargin();
+		static unsigned int getHeapFree();
+		static unsigned int getHeapLargest();
+};
+
+#endif
@@ -0,0 +1,94 @@
+/*
+		PID.cpp - Implémentation de la librairie de régulation PID en virgule fixe
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		La consigne et la mesure sont données en centièmes de degré (comme Fixed::toHundredths) et la sortie en pour mille
+		Les gains sont donnés en virgule fixe, avec PID_GAIN_SHIFT bits de fraction, puis ramenés une fois pour toutes au centième de degré:
+			- kp: pour mille de sortie par degré d'écart
+			- ki: pour mille de sortie ajoutés chaque minute par degré d'écart
+			- kd: pour mille de sortie par degré et par minute de variation de la mesure
+		Aucun calcul en virgule flottante n'est fait à chaque période: tout tient dans des entiers de 32 bits
+		Les calculs sont faits en int32_t plutôt qu'en long pour que l'exécution native, où long fait 64 bits,
+		ait les mêmes bornes que l'AVR
+
+		La dérivée porte sur la mesure et non sur l'écart, un changement de consigne ne provoque donc pas de pic de sortie
+		L'intégrale est bornée à la plage de sortie et n'est pas accumulée quand la sortie est déjà saturée dans le sens de l'écart,
+		elle ne s'emballe donc pas pendant une longue chauffe (anti-windup)
+*/
+
+#include <PID.h>
+
+// Constructeur de la classe PID
+// Tous les gains sont nuls, la sortie l'est donc aussi tant que setGains() n'a pas été appelée
+//
+PID::PID(){
+	kp = 0;
+	ki = 0;
+	kd = 0;
+	reset();
+}
+
+// Méthode réglant les gains du régulateur, chacun borné à sa limite
+// Les gains sont en virgule fixe avec PID_GAIN_SHIFT bits de fraction, comme ceux lus par Fixed::parse()
+//	- kp: gain proportionnel, en pour mille par degré
+//	- ki: gain intégral, en pour mille par degré et par minute
+//	- kd: gain dérivé, en pour mille par degré par minute
+//
+void PID::setGains(long kp, long ki, long kd){
+	this->kp = (constrain(kp, 0L, (long)PID_KP_MAX << PID_GAIN_SHIFT) + 50) / 100;
+	this->ki = (constrain(ki, 0L, (long)PID_KI_MAX << PID_GAIN_SHIFT) + 50) / 100;
+	this->kd = (constrain(kd, 0L, (long)PID_KD_MAX << PID_GAIN_SHIFT) + 50) / 100;
+}
+
+// Méthode remettant à zéro l'intégrale et l'historique de la mesure
+// A appeler quand la régulation est interrompue, par exemple si la sonde est déconnectée
+//
+void PID::reset(){
+	integral = 0;
+	hasLastInput = false;
+	output = 0;
+}
+
+// Méthode calculant la sortie du régulateur pour une nouvelle période
+//	- setpoint: la consigne, en centièmes de degré
+//	- input: la mesure, en centièmes de degré
+//	- dt: la durée écoulée depuis le calcul précédent, en secondes
+// Retourne la sortie, de 0 à PID_OUTPUT_MAX pour mille
+//
+int PID::compute(long setpoint, long input, unsigned int dt){
+	if(dt == 0) return output;
+	int32_t error = constrain(setpoint - input, (long)-PID_ERROR_MAX, (long)PID_ERROR_MAX);
+
+	// Terme proportionnel
+	int32_t proportional = kp * error / 65536;
+
+	// Terme dérivé, sur la variation de la mesure ramenée à la minute
+	int32_t derivative = 0;
+	if(hasLastInput){
+		int32_t rate = constrain((int32_t)(input - lastInput) * 60 / (int32_t)dt, (int32_t)-PID_ERROR_MAX, (int32_t)PID_ERROR_MAX);
+		derivative = -kd * rate / 65536;
+	}
+	lastInput = input;
+	hasLastInput = true;
+
+	// Terme intégral, accumulé seulement si la sortie n'est pas déjà saturée dans le sens de l'écart
+	// Le pas par seconde est d'abord borné à celui qui parcourt toute la plage de l'intégrale en dt secondes:
+	// le résultat est le même, l'intégrale étant de toute façon bornée, et le produit par dt tient sur 32 bits
+	// (arrondi au-dessus pour que ce pas atteigne bien la saturation)
+	int32_t range = (int32_t)PID_OUTPUT_MAX * 65536;
+	int32_t limit = (range + (int32_t)dt - 1) / (int32_t)dt;
+	int32_t step = constrain(ki * error / 60, -limit, limit);
+	int32_t candidate = constrain(integral + step * (int32_t)dt, (int32_t)0, range);
+	int32_t total = proportional + candidate / 65536 + derivative;
+	if(!(total > PID_OUTPUT_MAX && error > 0) && !(total < 0 && error < 0)) integral = candidate;
+
+	output = constrain(proportional + integral / 65536 + derivative, (int32_t)0, (int32_t)PID_OUTPUT_MAX);
+	return output;
+}
+
+// Méthode retournant la dernière sortie calculée, en pour mille
+//
+int PID::getOutput(){
+	return output;
+}
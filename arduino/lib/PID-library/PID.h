@@ -0,0 +1,48 @@
+/*
+		PID.h - Librairie de régulation PID en virgule fixe
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+*/
+
+#ifndef PID_h
+#define PID_h
+
+#include <Arduino.h>
+
+// Ecart maximal pris en compte, en centièmes de degré: au-delà, la sortie est de toute façon saturée
+// Avec les limites des gains, il borne les produits de l'écart par un gain pour qu'ils tiennent sur 32 bits
+// Le pas de l'intégrale, multiplié par la période, est en plus borné par compute() à ce qui sature l'intégrale
+#define PID_ERROR_MAX 2000
+
+// Limites des gains acceptés par setGains()
+#define PID_KP_MAX 1000
+#define PID_KI_MAX 100
+#define PID_KD_MAX 1000
+
+// Sortie maximale, en pour mille
+#define PID_OUTPUT_MAX 1000
+
+// Nombre de bits de la partie fractionnaire des gains passés à setGains()
+#define PID_GAIN_SHIFT 16
+
+class PID{
+
+	public:
+		PID();
+
+		void setGains(long kp, long ki, long kd);
+		void reset();
+		int compute(long setpoint, long input, unsigned int dt);
+		int getOutput();
+
+	private:
+		int32_t kp;
+		int32_t ki;
+		int32_t kd;
+		int32_t integral;
+		int32_t lastInput;
+		bool hasLastInput;
+		int output;
+};
+
+#endif
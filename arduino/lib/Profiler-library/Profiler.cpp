@@ -0,0 +1,101 @@
+/*
+		Profiler.cpp - Implémentation de la librairie de mesure des temps d'exécution basée sur micros()
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Chaque sonde mesure une portion de code: on relève micros() avant, puis on appelle record() après
+		Elle conserve le nombre d'exécutions, les durées minimale, maximale et cumulée et un histogramme logarithmique,
+		le tout dans des compteurs de taille fixe: une sonde coûte quelques microsecondes et aucune allocation
+		Les durées minimale et maximale sont plafonnées à 65535 µs
+		Quand le nombre d'exécutions ou la durée cumulée va déborder, tous les compteurs de la sonde sont divisés par deux:
+		la moyenne et la forme de l'histogramme sont conservées, les exécutions récentes pèsent simplement plus lourd
+*/
+
+#include <Profiler.h>
+
+// Constructeur de la classe Profiler
+//
+Profiler::Profiler(){
+	probeCount = 0;
+}
+
+// Méthode permettant d'enregistrer une sonde dans la table
+//	- name: le nom de la sonde, rapporté avec ses mesures et conservé en mémoire flash, déclaré avec F("...")
+// Retourne l'identifiant de la sonde ou -1 si la table est pleine
+//
+int8_t Profiler::addProbe(const __FlashStringHelper* name){
+	if(probeCount >= PROFILER_MAX_PROBES) return -1;
+	Probe* probe = &probes[probeCount];
+	probe->name = name;
+	clear(probe);
+	return probeCount++;
+}
+
+// Méthode enregistrant la durée d'une exécution, de start jusqu'à maintenant
+//	- id: l'identifiant retourné par addProbe
+//	- start: la valeur de micros() relevée au début de l'exécution
+//
+void Profiler::record(int8_t id, unsigned long start){
+	unsigned long duration = micros() - start;
+	if(id < 0 || id >= probeCount) return;
+	Probe* probe = &probes[id];
+	if(probe->count == 0xFFFF || probe->total > 0xFFFFFFFFUL - duration) halve(probe);
+	uint16_t clipped = duration > 0xFFFF ? 0xFFFF : duration;
+	if(clipped < probe->minimum) probe->minimum = clipped;
+	if(clipped > probe->maximum) probe->maximum = clipped;
+	probe->total += duration;
+	probe->count++;
+	uint8_t bin = 0;
+	while(bin < PROFILER_BINS - 1 && duration >= ((unsigned long)PROFILER_BASE << bin)) bin++;
+	probe->bins[bin]++;
+}
+
+// Méthode remettant à zéro les compteurs de toutes les sondes
+//
+void Profiler::reset(){
+	for(uint8_t i = 0; i < probeCount; i++) clear(&probes[i]);
+}
+
+// Méthode retournant le nombre de sondes enregistrées
+//
+uint8_t Profiler::getProbeCount(){
+	return probeCount;
+}
+
+// Méthode retournant les compteurs d'une sonde
+//	- id: l'identifiant retourné par addProbe
+// Retourne NULL si la sonde n'existe pas
+//
+const Profiler::Probe* Profiler::getProbe(uint8_t id){
+	if(id >= probeCount) return NULL;
+	return &probes[id];
+}
+
+// Méthode retournant la durée moyenne d'une exécution en microsecondes, plafonnée à 65535 µs
+//	- id: l'identifiant retourné par addProbe
+//
+uint16_t Profiler::getMean(uint8_t id){
+	if(id >= probeCount || probes[id].count == 0) return 0;
+	uint32_t mean = probes[id].total / probes[id].count;
+	return mean > 0xFFFF ? 0xFFFF : mean;
+}
+
+// Méthode remettant à zéro les compteurs d'une sonde
+// Le minimum part du plafond pour que la première exécution le remplace
+//
+void Profiler::clear(Probe* probe){
+	probe->count = 0;
+	probe->minimum = 0xFFFF;
+	probe->maximum = 0;
+	probe->total = 0;
+	for(uint8_t i = 0; i < PROFILER_BINS; i++) probe->bins[i] = 0;
+}
+
+// Méthode divisant par deux les compteurs cumulés d'une sonde avant qu'ils ne débordent
+// Les durées minimale et maximale sont conservées
+//
+void Profiler::halve(Probe* probe){
+	probe->count /= 2;
+	probe->total /= 2;
+	for(uint8_t i = 0; i < PROFILER_BINS; i++) probe->bins[i] /= 2;
+}
@@ -0,0 +1,51 @@
+/*
+		Profiler.h - Librairie de mesure des temps d'exécution basée sur micros()
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+*/
+
+#ifndef Profiler_h
+#define Profiler_h
+
+#include <Arduino.h>
+
+// Nombre maximal de sondes enregistrées dans la table
+#ifndef PROFILER_MAX_PROBES
+#define PROFILER_MAX_PROBES 12
+#endif
+
+// Nombre de classes de l'histogramme et borne en microsecondes de la première classe
+// La classe i compte les durées inférieures à PROFILER_BASE << i, la dernière toutes les durées plus longues
+#define PROFILER_BINS 8
+#define PROFILER_BASE 16
+
+class Profiler{
+
+	public:
+		typedef struct{
+			const __FlashStringHelper* name;
+			uint16_t count;
+			uint16_t minimum;
+			uint16_t maximum;
+			uint32_t total;
+			uint16_t bins[PROFILER_BINS];
+		} Probe;
+
+		Profiler();
+
+		int8_t addProbe(const __FlashStringHelper* name);
+		void record(int8_t id, unsigned long start);
+		void reset();
+		uint8_t getProbeCount();
+		const Probe* getProbe(uint8_t id);
+		uint16_t getMean(uint8_t id);
+
+	private:
+		Probe probes[PROFILER_MAX_PROBES];
+		uint8_t probeCount;
+
+		void clear(Probe* probe);
+		void halve(Probe* probe);
+};
+
+#endif
@@ -0,0 +1,110 @@
+/*
+		Scheduler.cpp - Implémentation de la librairie d'ordonnancement de tâches périodiques basée sur millis()
+		Ecrit par Christophe BURY
+		Date de première release: 16/10/2026
+
+		Chaque tâche a une période et une échéance absolue exprimées en millisecondes
+		L'échéance suivante est toujours calculée à partir de l'échéance précédente et non de l'heure d'exécution,
+		le retard pris par une tâche lente ne s'accumule donc jamais sur les autres périodes
+*/
+
+#include <Scheduler.h>
+
+// Définition des politiques de rattrapage lorsqu'une ou plusieurs échéances ont été manquées
+//	- CATCH_UP: la tâche est exécutée une fois par échéance manquée, aux itérations suivantes de la boucle
+//	- SKIP: les échéances manquées sont abandonnées et la tâche reprend à la prochaine échéance de sa grille
+const uint8_t Scheduler::CATCH_UP = 0;
+const uint8_t Scheduler::SKIP = 1;
+
+// Constructeur de la classe Scheduler
+//
+Scheduler::Scheduler(){
+	taskCount = 0;
+	profiler = NULL;
+}
+
+// Méthode permettant d'enregistrer une tâche dans la table
+// La première exécution a lieu une période après l'enregistrement
+//	- task: la procédure à exécuter
+//	- period: la période d'exécution en millisecondes
+//	- policy: la politique de rattrapage (CATCH_UP ou SKIP)
+// Retourne l'identifiant de la tâche ou -1 si la table est pleine
+//
+int8_t Scheduler::addTask(Task task, unsigned long period, uint8_t policy){
+	if(taskCount >= SCHEDULER_MAX_TASKS) return -1;
+	Entry* entry = &tasks[taskCount];
+	entry->task = task;
+	entry->period = period;
+	entry->deadline = millis() + period;
+	entry->policy = policy;
+	entry->overruns = 0;
+	entry->probe = -1;
+	return taskCount++;
+}
+
+// Méthode appelée à chaque itération de la boucle principale qui exécute les tâches arrivées à échéance
+// Une tâche dont l'échéance suivante est elle aussi déjà dépassée est en dépassement, on le compte
+// Si la tâche a une sonde, sa durée d'exécution est enregistrée par le profileur
+//
+void Scheduler::run(){
+	for(uint8_t i = 0; i < taskCount; i++){
+		Entry* entry = &tasks[i];
+		unsigned long now = millis();
+		if((long)(now - entry->deadline) >= 0){
+			unsigned long start = micros();
+			entry->task();
+			if(profiler != NULL) profiler->record(entry->probe, start);
+			entry->deadline += entry->period;
+			now = millis();
+			if((long)(now - entry->deadline) >= 0){
+				if(entry->overruns < 0xFFFF) entry->overruns++;
+				if(entry->policy == SKIP){
+					while((long)(now - entry->deadline) >= 0) entry->deadline += entry->period;
+				}
+			}
+		}
+	}
+}
+
+// Méthode permettant de changer la période d'une tâche
+// La prochaine exécution a lieu une nouvelle période après le changement
+//	- id: l'identifiant retourné par addTask
+//	- period: la nouvelle période d'exécution en millisecondes
+//
+void Scheduler::setPeriod(int8_t id, unsigned long period){
+	if(id < 0 || id >= taskCount) return;
+	tasks[id].period = period;
+	tasks[id].deadline = millis() + period;
+}
+
+// Méthode retournant le nombre de dépassements d'une tâche
+//	- id: l'identifiant retourné par addTask
+//
+unsigned int Scheduler::getOverruns(int8_t id){
+	if(id < 0 || id >= taskCount) return 0;
+	return tasks[id].overruns;
+}
+
+// Méthode retournant le nombre de dépassements cumulés de toutes les tâches
+//
+unsigned long Scheduler::getTotalOverruns(){
+	unsigned long total = 0;
+	for(uint8_t i = 0; i < taskCount; i++) total += tasks[i].overruns;
+	return total;
+}
+
+// Méthode permettant de désigner le profileur qui mesure la durée d'exécution des tâches
+//	- profiler: le profileur, NULL pour ne plus mesurer
+//
+void Scheduler::setProfiler(Profiler* profiler){
+	this->profiler = profiler;
+}
+
+// Méthode permettant d'associer une sonde du profileur à une tâche
+//	- id: l'identifiant retourné par addTask
+//	- probe: l'identifiant retourné par Profiler::addProbe
+//
+void Scheduler::setProbe(int8_t id, int8_t probe){
+	if(id < 0 || id >= taskCount) return;
+	tasks[id].probe = probe;
+}
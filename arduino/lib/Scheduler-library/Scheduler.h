@@ -0,0 +1,51 @@
+/*
+		Scheduler.h - Librairie d'ordonnancement de tâches périodiques basée sur millis()
+		Ecrit par Christophe BURY
+		Date de première release: 16/10/2026
+*/
+
+#ifndef Scheduler_h
+#define Scheduler_h
+
+#include <Arduino.h>
+#include <Profiler.h>
+
+// Nombre maximal de tâches enregistrées dans la table
+#ifndef SCHEDULER_MAX_TASKS
+#define SCHEDULER_MAX_TASKS 10
+#endif
+
+class Scheduler{
+
+	public:
+		static const uint8_t CATCH_UP;
+		static const uint8_t SKIP;
+
+		typedef void (*Task)();
+
+		Scheduler();
+
+		int8_t addTask(Task task, unsigned long period, uint8_t policy);
+		void run();
+		void setPeriod(int8_t id, unsigned long period);
+		unsigned int getOverruns(int8_t id);
+		unsigned long getTotalOverruns();
+		void setProfiler(Profiler* profiler);
+		void setProbe(int8_t id, int8_t probe);
+
+	private:
+		typedef struct{
+			Task task;
+			unsigned long period;
+			unsigned long deadline;
+			uint8_t policy;
+			unsigned int overruns;
+			int8_t probe;
+		} Entry;
+
+		Entry tasks[SCHEDULER_MAX_TASKS];
+		uint8_t taskCount;
+		Profiler* profiler;
+};
+
+#endif
@@ -0,0 +1,317 @@
+/*
+		Sensors.cpp - Implémentation de la librairie de registre des sondes
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Le registre est une table statique déclarée par le firmware avec SENSOR(): chaque sonde y a son type,
+		sa broche ou son rang sur le bus 1-Wire et sa zone. C'est aussi le cache des mesures, le seul endroit où
+		l'écran, l'historique et la régulation lisent les valeurs des sondes: chaque sonde y garde sa dernière mesure
+		brute et convertie en virgule fixe Q7, l'heure de cette mesure en millisecondes et à l'horloge de l'unité,
+		l'état de la mesure et son nombre d'échecs de lecture consécutifs
+		Les valeurs sont lues par zone avec un âge maximal: une mesure trop ancienne est ignorée plutôt qu'utilisée
+		Toutes les sondes DS18B20 partagent un seul bus: une seule commande STARTCONVO, adressée à toutes les sondes
+		par un skip ROM, lance leurs conversions en même temps. Une fois la conversion terminée, elles sont lues
+		l'une après l'autre par leur adresse, une seule par appel de update() pour ne pas retenir la boucle principale
+		Les capteurs DHT sont lus l'un après l'autre par un seul lecteur asynchrone, redirigé vers chaque broche:
+		son état de lecture n'existe ainsi qu'une fois quel que soit le nombre de capteurs
+		Les deux bus avancent en parallèle, le cycle se termine quand toutes les sondes ont été lues
+		Une fois les adresses trouvées par begin(), toutes les transactions sur le bus 1-Wire sont faites par update():
+		isBusNeeded() annonce la prochaine, ce qui permet à l'appelant de la retarder tant qu'une liaison sensible
+		au masquage des interruptions est en cours d'envoi
+*/
+
+#include <Sensors.h>
+
+// Constructeur de la classe Sensors
+//	- bus: le bus 1-Wire des sondes DS18B20
+//	- reader: le lecteur asynchrone partagé par les capteurs DHT
+//	- probes: la table des sondes, déclarées avec SENSOR()
+//	- count: le nombre de sondes de la table, au plus SENSOR_MAX_PROBES
+//
+Sensors::Sensors(DallasTemperature* bus, DHT* reader, Probe* probes, uint8_t count){
+	this->bus = bus;
+	this->reader = reader;
+	this->probes = probes;
+	this->count = min(count, (uint8_t)SENSOR_MAX_PROBES);
+	zoneCount = 0;
+	for(uint8_t i = 0; i < this->count; i++){
+		if(probes[i].zone < SENSOR_MAX_ZONES && probes[i].zone >= zoneCount) zoneCount = probes[i].zone + 1;
+	}
+	waterNext = this->count;
+	airNext = this->count;
+	isAirReading = false;
+	isCycling = false;
+	isConversionPending = false;
+	pendingResolution = 0;
+}
+
+// Méthode cherchant l'adresse de chaque sonde DS18B20 d'après son rang sur le bus
+// Le bus doit avoir été démarré auparavant; une sonde introuvable sera recherchée à nouveau à chaque cycle
+//
+void Sensors::begin(){
+	for(uint8_t i = 0; i < count; i++){
+		if(probes[i].kind == SENSOR_DS18B20 && !bus->getAddress(probes[i].address, probes[i].pin)) probes[i].address[0] = 0;
+	}
+}
+
+// Méthode lançant un cycle de mesure de toutes les sondes
+// La conversion des sondes DS18B20 est demandée par le prochain appel de update()
+// Retourne false si un cycle est déjà en cours
+//
+bool Sensors::startCycle(){
+	if(isCycling) return false;
+	waterNext = nextProbe(0, true);
+	isConversionPending = waterNext < count;
+	airNext = nextProbe(0, false);
+	isAirReading = false;
+	isCycling = true;
+	return true;
+}
+
+// Méthode à appeler à chaque itération, qui avance le cycle de mesure en cours
+// Retourne true une seule fois, quand la dernière sonde du cycle vient d'être lue
+//
+bool Sensors::update(){
+	reader->update();
+	if(!isCycling) return false;
+
+	// Sondes DS18B20: la recherche des sondes perdues, la résolution demandée et le lancement de la conversion commune,
+	// puis une lecture par appel une fois la conversion terminée
+	if(isConversionPending){
+		locateWater();
+		if(pendingResolution != 0){
+			bus->setResolution(pendingResolution, false);
+			pendingResolution = 0;
+		}
+		bus->requestTemperatures();
+		conversionStart = millis();
+		conversionDelay = getConversionTime();
+		isConversionPending = false;
+	}
+	else if(waterNext < count && millis() - conversionStart >= (unsigned long)conversionDelay){
+		readWater(&probes[waterNext]);
+		waterNext = nextProbe(waterNext + 1, true);
+	}
+
+	// Capteurs DHT: on collecte la lecture en cours, ou on lance celle du capteur suivant
+	// Un capteur lu il y a moins de SENSOR_DHT_INTERVAL garde sa dernière mesure
+	if(isAirReading){
+		if(reader->isReady()){
+			readAir(&probes[airNext]);
+			isAirReading = false;
+			airNext = nextProbe(airNext + 1, false);
+		}
+	}
+	else if(airNext < count){
+		Probe* probe = &probes[airNext];
+		if(probe->time != 0 && millis() - probe->time < SENSOR_DHT_INTERVAL) airNext = nextProbe(airNext + 1, false);
+		else if(reader->setSensor(probe->pin, probe->kind) && reader->startRead(true)) isAirReading = true;
+	}
+
+	if(waterNext >= count && airNext >= count){
+		isCycling = false;
+		return true;
+	}
+	return false;
+}
+
+// Méthode retournant true pendant un cycle de mesure
+//
+bool Sensors::isBusy(){
+	return isCycling;
+}
+
+// Méthode retournant true si le prochain appel de update() fera une transaction sur le bus 1-Wire
+// Chaque bit d'une transaction masque les interruptions pendant une soixantaine de microsecondes
+//
+bool Sensors::isBusNeeded(){
+	return isConversionPending || (waterNext < count && millis() - conversionStart >= (unsigned long)conversionDelay);
+}
+
+// Méthode réglant la résolution de toutes les sondes DS18B20, de 9 bits (0,5°C, 94 ms de conversion) à 12 bits
+// (0,0625°C, 750 ms), appliquée dès le prochain cycle, juste avant le lancement de sa conversion
+// La résolution n'est écrite que dans le scratchpad des sondes, pas dans leur EEPROM qui s'userait à chaque changement:
+// au démarrage, elles reprennent la résolution enregistrée
+// Retourne false si un cycle est en cours: on ne change pas la résolution d'une conversion en cours
+//	- bits: la résolution, de 9 à 12 bits
+//
+bool Sensors::setResolution(uint8_t bits){
+	if(isCycling) return false;
+	pendingResolution = bits;
+	return true;
+}
+
+// Méthode retournant la résolution des sondes DS18B20, en bits, y compris celle demandée pour le prochain cycle
+//
+uint8_t Sensors::getResolution(){
+	return pendingResolution != 0 ? pendingResolution : bus->getResolution();
+}
+
+// Méthode retournant la durée de conversion des sondes DS18B20 à leur résolution, en millisecondes
+//
+int Sensors::getConversionTime(){
+	return bus->millisToWaitForConversion(getResolution());
+}
+
+// Méthode retournant le nombre de sondes du registre
+//
+uint8_t Sensors::getCount(){
+	return count;
+}
+
+// Méthode retournant le nombre de zones, numérotées à partir de 0
+//
+uint8_t Sensors::getZoneCount(){
+	return zoneCount;
+}
+
+// Méthode retournant une sonde du registre, NULL si l'identifiant n'existe pas
+//
+const Sensors::Probe* Sensors::getProbe(uint8_t id){
+	return id < count ? &probes[id] : NULL;
+}
+
+// Méthode retournant true si la sonde a échoué à SENSOR_MAX_FAILURES lectures consécutives ou plus
+//
+bool Sensors::isDown(uint8_t id){
+	return id < count && probes[id].failures >= SENSOR_MAX_FAILURES;
+}
+
+// Méthode retournant le masque des sondes en panne, le bit i correspondant à la sonde i
+//
+uint16_t Sensors::getDownMask(){
+	uint16_t mask = 0;
+	for(uint8_t i = 0; i < count; i++){
+		if(isDown(i)) mask |= (uint16_t)1 << i;
+	}
+	return mask;
+}
+
+// Méthode donnant la mesure d'une grandeur dans une zone: la moyenne des sondes de la zone dont la mesure est utilisable,
+// c'est-à-dire ni absente, ni trop ancienne, ni celle d'une sonde en panne
+// L'heure de la mesure est celle de la plus ancienne des mesures moyennées; son état est SENSOR_HELD si l'une d'elles
+// est conservée après un échec, SENSOR_VALID sinon. Sans mesure utilisable, la valeur est FIXED_INVALID et l'état
+// est le plus grave parmi les sondes de la zone, SENSOR_EMPTY si aucune ne mesure cette grandeur
+//	- zone: le numéro de la zone
+//	- quantity: SENSOR_WATER_TEMPERATURE, SENSOR_AIR_TEMPERATURE ou SENSOR_AIR_HUMIDITY
+//	- maxAge: l'âge maximal d'une mesure utilisable, en millisecondes
+//	- sample: reçoit la mesure
+// Retourne true si la mesure est utilisable
+//
+bool Sensors::getZoneSample(uint8_t zone, uint8_t quantity, unsigned long maxAge, Sample* sample){
+	unsigned long current = millis();
+	long total = 0;
+	uint8_t values = 0;
+	uint8_t status = SENSOR_EMPTY;
+	bool isHeld = false;
+	sample->time = 0;
+	sample->clock = 0;
+	for(uint8_t i = 0; i < count; i++){
+		Probe* probe = &probes[i];
+		if(probe->zone != zone || (probe->kind == SENSOR_DS18B20) != (quantity == SENSOR_WATER_TEMPERATURE)) continue;
+		uint8_t probeStatus = probe->status;
+		if((probeStatus == SENSOR_VALID || probeStatus == SENSOR_HELD) && current - probe->time > maxAge) probeStatus = SENSOR_STALE;
+		if(probeStatus != SENSOR_VALID && probeStatus != SENSOR_HELD){
+			if(probeStatus > status) status = probeStatus;
+			continue;
+		}
+		total += quantity == SENSOR_AIR_HUMIDITY ? probe->humidity : probe->temperature;
+		if(values == 0 || current - probe->time > current - sample->time){
+			sample->time = probe->time;
+			sample->clock = probe->clock;
+		}
+		if(probeStatus == SENSOR_HELD) isHeld = true;
+		values++;
+	}
+	if(values == 0){
+		sample->value = FIXED_INVALID;
+		sample->status = status;
+		return false;
+	}
+	sample->value = total / values;
+	sample->status = isHeld ? SENSOR_HELD : SENSOR_VALID;
+	return true;
+}
+
+// Méthode retournant la mesure utilisable d'une grandeur dans une zone, FIXED_INVALID s'il n'y en a pas
+// Voir getZoneSample() pour le détail des paramètres
+//
+fixed_t Sensors::getZoneValue(uint8_t zone, uint8_t quantity, unsigned long maxAge){
+	Sample sample;
+	getZoneSample(zone, quantity, maxAge, &sample);
+	return sample.value;
+}
+
+// Méthode privée retournant l'identifiant de la prochaine sonde d'eau (water) ou d'air à partir de from
+// Retourne le nombre de sondes s'il n'y en a plus
+//
+uint8_t Sensors::nextProbe(uint8_t from, bool water){
+	while(from < count && (probes[from].kind == SENSOR_DS18B20) != water) from++;
+	return from;
+}
+
+// Méthode privée recherchant à nouveau les sondes DS18B20 sur le bus si l'une d'elles a perdu son adresse
+// Les adresses sont gardées en cache par la librairie depuis le démarrage: seule une nouvelle recherche (rescan)
+// trouve une sonde branchée ou remplacée depuis. La résolution courante est réappliquée à la conversion qui suit,
+// une sonde qui vient d'être branchée démarrant avec celle enregistrée dans son EEPROM
+//
+void Sensors::locateWater(){
+	for(uint8_t i = 0; i < count; i++){
+		if(probes[i].kind == SENSOR_DS18B20 && probes[i].address[0] == 0){
+			uint8_t resolution = getResolution();
+			bus->rescan();
+			begin();
+			pendingResolution = resolution;
+			return;
+		}
+	}
+}
+
+// Méthode privée lisant le résultat de conversion d'une sonde DS18B20 par son adresse
+// Une sonde introuvable ou illisible perd son adresse: elle sera recherchée sur le bus au prochain cycle
+// En dessous de 12 bits, les bits de poids faible non convertis sont indéfinis d'après la fiche technique: on les efface
+//
+void Sensors::readWater(Probe* probe){
+	int16_t raw = probe->address[0] != 0 ? bus->getTemp(probe->address) : DEVICE_DISCONNECTED_RAW;
+	if(raw == DEVICE_DISCONNECTED_RAW){
+		probe->address[0] = 0;
+		fail(probe);
+	}
+	else{
+		probe->rawTemperature = raw;
+		probe->temperature = raw & ~((1 << (15 - bus->getResolution())) - 1);
+		succeed(probe);
+	}
+}
+
+// Méthode privée collectant la lecture terminée d'un capteur DHT
+//
+void Sensors::readAir(Probe* probe){
+	int16_t temperature = reader->getFixedTemperature();
+	int16_t humidity = reader->getFixedHumidity();
+	if(temperature == DHT_FIXED_INVALID || humidity == DHT_FIXED_INVALID) fail(probe);
+	else{
+		probe->rawTemperature = reader->getRawTemperature();
+		probe->rawHumidity = reader->getRawHumidity();
+		probe->temperature = temperature;
+		probe->humidity = humidity;
+		succeed(probe);
+	}
+}
+
+// Méthode privée horodatant une lecture réussie, en millisecondes et à l'horloge de l'unité
+//
+void Sensors::succeed(Probe* probe){
+	probe->time = millis();
+	probe->clock = now();
+	probe->status = SENSOR_VALID;
+	probe->failures = 0;
+}
+
+// Méthode privée comptant un échec de lecture, la dernière mesure valide est conservée
+//
+void Sensors::fail(Probe* probe){
+	if(probe->failures < UINT8_MAX) probe->failures++;
+	if(probe->failures >= SENSOR_MAX_FAILURES) probe->status = SENSOR_DOWN;
+	else if(probe->status != SENSOR_EMPTY) probe->status = SENSOR_HELD;
+}
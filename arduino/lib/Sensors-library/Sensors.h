@@ -0,0 +1,119 @@
+/*
+		Sensors.h - Librairie de registre des sondes de l'unité, réparties par zones
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+*/
+
+#ifndef Sensors_h
+#define Sensors_h
+
+#include <Arduino.h>
+#include <Time.h>
+#include <DHT.h>
+#include <DallasTemperature.h>
+#include <Fixed.h>
+
+// Types de sondes: sonde de température de l'eau sur le bus 1-Wire et capteurs de température et d'humidité de l'air
+#define SENSOR_DS18B20 0
+#define SENSOR_DHT11 DHT11
+#define SENSOR_DHT22 DHT22
+
+// Grandeurs mesurées dans chaque zone
+#define SENSOR_WATER_TEMPERATURE 0
+#define SENSOR_AIR_TEMPERATURE 1
+#define SENSOR_AIR_HUMIDITY 2
+
+// Etat d'une mesure du registre
+//	- SENSOR_EMPTY: aucune lecture n'a encore réussi
+//	- SENSOR_VALID: la dernière lecture a réussi
+//	- SENSOR_HELD: la dernière lecture a échoué, la mesure précédente est conservée
+//	- SENSOR_STALE: la mesure est plus ancienne que l'âge maximal demandé, elle n'est pas utilisée
+//	- SENSOR_DOWN: la sonde est en panne, sa mesure n'est pas utilisée
+#define SENSOR_EMPTY 0
+#define SENSOR_VALID 1
+#define SENSOR_HELD 2
+#define SENSOR_STALE 3
+#define SENSOR_DOWN 4
+
+// Nombre maximal de sondes du registre et de zones
+// Le masque des sondes en panne doit tenir dans un entier positif de 16 bits
+#define SENSOR_MAX_PROBES 15
+#define SENSOR_MAX_ZONES 8
+
+// Nombre d'échecs de lecture consécutifs à partir duquel une sonde est en panne: ses mesures sont alors ignorées
+// En dessous, la dernière mesure valide est conservée: un échec isolé, fréquent sur un long câble, est ainsi toléré
+#define SENSOR_MAX_FAILURES 2
+
+// Intervalle minimal entre deux lectures d'un même capteur DHT, en millisecondes
+#define SENSOR_DHT_INTERVAL 2000
+
+// Déclaration d'une sonde du registre: type, broche du capteur DHT ou rang de la sonde DS18B20 sur le bus, et zone
+#define SENSOR(kind, pin, zone) { kind, pin, zone, { 0 }, 0, 0, FIXED_INVALID, FIXED_INVALID, 0, 0, SENSOR_EMPTY, 0 }
+
+class Sensors{
+
+	public:
+		typedef struct{
+			uint8_t kind;
+			uint8_t pin;
+			uint8_t zone;
+			DeviceAddress address;
+			uint16_t rawTemperature;
+			uint16_t rawHumidity;
+			fixed_t temperature;
+			fixed_t humidity;
+			unsigned long time;
+			time_t clock;
+			uint8_t status;
+			uint8_t failures;
+		} Probe;
+
+		typedef struct{
+			fixed_t value;
+			uint8_t status;
+			unsigned long time;
+			time_t clock;
+		} Sample;
+
+		Sensors(DallasTemperature* bus, DHT* reader, Probe* probes, uint8_t count);
+
+		void begin();
+		bool startCycle();
+		bool update();
+		bool isBusy();
+		bool isBusNeeded();
+		bool setResolution(uint8_t bits);
+		uint8_t getResolution();
+		int getConversionTime();
+		uint8_t getCount();
+		uint8_t getZoneCount();
+		const Probe* getProbe(uint8_t id);
+		bool isDown(uint8_t id);
+		uint16_t getDownMask();
+		bool getZoneSample(uint8_t zone, uint8_t quantity, unsigned long maxAge, Sample* sample);
+		fixed_t getZoneValue(uint8_t zone, uint8_t quantity, unsigned long maxAge);
+
+	private:
+		DallasTemperature* bus;
+		DHT* reader;
+		Probe* probes;
+		uint8_t count;
+		uint8_t zoneCount;
+		uint8_t waterNext;
+		uint8_t airNext;
+		bool isAirReading;
+		bool isCycling;
+		bool isConversionPending;
+		uint8_t pendingResolution;
+		unsigned long conversionStart;
+		int conversionDelay;
+
+		uint8_t nextProbe(uint8_t from, bool water);
+		void locateWater();
+		void readWater(Probe* probe);
+		void readAir(Probe* probe);
+		void succeed(Probe* probe);
+		void fail(Probe* probe);
+};
+
+#endif
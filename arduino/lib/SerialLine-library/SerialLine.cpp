@@ -0,0 +1,90 @@
+/*
+		SerialLine.cpp - Implémentation de la librairie d'assemblage et de découpage des lignes reçues sur un port série
+		Ecrit par Christophe BURY
+		Date de première release: 16/10/2026
+
+		Les octets sont lus un par un tant que le port série en a de disponibles, sans jamais attendre
+		La ligne est assemblée dans un tampon de taille fixe puis découpée sur place: les éléments retournés
+		pointent dans ce tampon, aucune chaîne n'est copiée ni allouée
+*/
+
+#include <SerialLine.h>
+
+// Constructeur de la classe SerialLine
+// Le paramètre stream désigne le port série à écouter (par exemple &Serial)
+//
+SerialLine::SerialLine(Stream* stream){
+	this->stream = stream;
+	length = 0;
+	complete = false;
+	overflow = false;
+	overflows = 0;
+}
+
+// Méthode vidant le port série dans le tampon de ligne
+// Retourne true dès qu'une ligne complète (terminée par "\n") est disponible, sans lire les octets suivants
+// La ligne reste disponible jusqu'à l'appel suivant, qui commence l'assemblage d'une nouvelle ligne
+// Une ligne trop longue pour le tampon est tronquée à SERIAL_LINE_LENGTH caractères, la suite étant ignorée
+// jusqu'à sa fin, et comptée comme débordement: elle est tout de même retournée pour que l'appelant puisse y répondre
+//
+bool SerialLine::read(){
+	if(complete){
+		length = 0;
+		complete = false;
+		overflow = false;
+	}
+	while(stream->available() > 0){
+		char c = stream->read();
+		if(c == '\n'){
+			buffer[length] = '\0';
+			complete = true;
+			return true;
+		}
+		else if(c != '\r'){
+			if(length < SERIAL_LINE_LENGTH) buffer[length++] = c;
+			else if(!overflow){
+				overflow = true;
+				overflows++;
+			}
+		}
+	}
+	return false;
+}
+
+// Méthode découpant sur place la ligne reçue en une commande et son paramètre
+// Le séparateur est remplacé par une fin de chaîne, les deux éléments sont donc aussi utilisables comme chaînes C
+//	- separator: le caractère séparant la commande du paramètre (par exemple ':')
+//	- command: reçoit la partie avant le séparateur
+//	- param: reçoit la partie après le séparateur
+// Une ligne sans séparateur est entièrement une commande, avec un paramètre vide (par exemple "STATS")
+// Retourne false si la ligne ne contient pas le séparateur
+//
+bool SerialLine::split(char separator, Token* command, Token* param){
+	char* found = (char*)memchr(buffer, separator, length);
+	if(found == NULL){
+		command->text = buffer;
+		command->length = length;
+		param->text = buffer + length;
+		param->length = 0;
+		return false;
+	}
+	*found = '\0';
+	command->text = buffer;
+	command->length = found - buffer;
+	param->text = found + 1;
+	param->length = length - command->length - 1;
+	return true;
+}
+
+// Méthode indiquant si la ligne reçue a été tronquée car trop longue pour le tampon
+// Une ligne tronquée ne doit pas être exécutée, seule sa commande est fiable
+//
+bool SerialLine::isTruncated(){
+	return overflow;
+}
+
+// Méthode retournant le nombre de lignes tronquées car trop longues
+//
+unsigned int SerialLine::getOverflows(){
+	return overflows;
+}
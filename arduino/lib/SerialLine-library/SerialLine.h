@@ -0,0 +1,42 @@
+/*
+		SerialLine.h - Librairie d'assemblage et de découpage des lignes reçues sur un port série, sans allocation dynamique
+		Ecrit par Christophe BURY
+		Date de première release: 16/10/2026
+*/
+
+#ifndef SerialLine_h
+#define SerialLine_h
+
+#include <Arduino.h>
+
+// Longueur maximale d'une ligne reçue, sans compter le caractère de fin de chaîne
+// Elle doit pouvoir contenir la trame SET_PROGRAM_BLOCK qui transporte tout le programme de germination
+#ifndef SERIAL_LINE_LENGTH
+#define SERIAL_LINE_LENGTH 127
+#endif
+
+class SerialLine{
+
+	public:
+		typedef struct{
+			const char* text;
+			uint8_t length;
+		} Token;
+
+		SerialLine(Stream* stream);
+
+		bool read();
+		bool split(char separator, Token* command, Token* param);
+		bool isTruncated();
+		unsigned int getOverflows();
+
+	private:
+		Stream* stream;
+		char buffer[SERIAL_LINE_LENGTH + 1];
+		uint8_t length;
+		bool complete;
+		bool overflow;
+		unsigned int overflows;
+};
+
+#endif
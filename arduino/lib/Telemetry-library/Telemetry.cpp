@@ -0,0 +1,59 @@
+/*
+		Telemetry.cpp - Implémentation de la librairie d'envoi de mesures en trames binaires COBS protégées par un CRC16
+		Ecrit par Christophe BURY
+		Date de première release: 16/10/2026
+
+		Une trame transporte une seule mesure: son identifiant, sa valeur sur 32 bits en little-endian et le CRC16
+		du bus 1-Wire (OneWire::crc16) calculé sur les 5 octets qui précèdent, lui aussi en little-endian
+		Les réels sont transmis en virgule fixe, multipliés par 100
+		La trame est encodée par COBS (Consistent Overhead Byte Stuffing) pour ne contenir aucun octet nul
+		et entourée de deux délimiteurs nuls
+*/
+
+#include <Telemetry.h>
+#include <OneWire.h>
+
+// Constructeur de la classe Telemetry
+// Le paramètre port désigne le port série sur lequel envoyer les trames (par exemple &Serial)
+//
+Telemetry::Telemetry(Print* port){
+	this->port = port;
+}
+
+// Méthode envoyant une mesure dans une trame binaire
+//	- id: l'identifiant fixe de la mesure, connu du PC
+//	- value: la valeur de la mesure, en virgule fixe pour les réels (voir Fixed::toHundredths())
+//
+void Telemetry::send(uint8_t id, long value){
+	uint8_t raw[TELEMETRY_RAW_LENGTH];
+	uint8_t frame[TELEMETRY_FRAME_LENGTH];
+
+	// Assemblage de la trame brute
+	raw[0] = id;
+	for(uint8_t i = 0; i < 4; i++) raw[1 + i] = (uint8_t)(value >> (8 * i));
+	uint16_t crc = OneWire::crc16(raw, 5);
+	raw[5] = crc & 0xFF;
+	raw[6] = crc >> 8;
+
+	// Encodage COBS: chaque octet nul est remplacé par la distance jusqu'au prochain octet nul
+	// Le premier octet de la trame encodée donne la distance jusqu'au premier octet nul remplacé
+	uint8_t length = 0;
+	frame[length++] = TELEMETRY_DELIMITER;
+	uint8_t codeIndex = length++;
+	uint8_t code = 1;
+	for(uint8_t i = 0; i < TELEMETRY_RAW_LENGTH; i++){
+		if(raw[i] == 0){
+			frame[codeIndex] = code;
+			codeIndex = length++;
+			code = 1;
+		}
+		else{
+			frame[length++] = raw[i];
+			code++;
+		}
+	}
+	frame[codeIndex] = code;
+	frame[length++] = TELEMETRY_DELIMITER;
+
+	port->write(frame, length);
+}
@@ -0,0 +1,33 @@
+/*
+		Telemetry.h - Librairie d'envoi de mesures en trames binaires COBS protégées par un CRC16
+		Ecrit par Christophe BURY
+		Date de première release: 16/10/2026
+*/
+
+#ifndef Telemetry_h
+#define Telemetry_h
+
+#include <Arduino.h>
+
+// Octet délimitant les trames binaires: il ne peut pas apparaître dans une trame encodée par COBS
+// ni dans une ligne du protocole texte, ce qui permet au PC de distinguer les deux
+#define TELEMETRY_DELIMITER 0x00
+
+// Longueur d'une trame avant encodage: identifiant (1 octet), valeur (4 octets) et CRC16 (2 octets)
+#define TELEMETRY_RAW_LENGTH 7
+
+// Longueur d'une trame envoyée: un délimiteur de début, la trame encodée (un octet de plus) et un délimiteur de fin
+#define TELEMETRY_FRAME_LENGTH (TELEMETRY_RAW_LENGTH + 3)
+
+class Telemetry{
+
+	public:
+		Telemetry(Print* port);
+
+		void send(uint8_t id, long value);
+
+	private:
+		Print* port;
+};
+
+#endif
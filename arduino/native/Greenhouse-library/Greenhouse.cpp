@@ -0,0 +1,237 @@
+/*
+		Greenhouse.cpp - Implémentation du modèle thermique de l'unité de germination
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Le modèle est du premier ordre, intégré par pas de GREENHOUSE_STEP seconde de temps virtuel:
+			- la pièce suit un profil jour/nuit sinusoïdal en température et en humidité
+			- l'air de l'unité tend vers celui de la pièce avec une constante de temps airTau, raccourcie par le ventilateur (airFanTau à pleine vitesse)
+			- l'eau tend vers l'air avec la constante de temps waterTau, la chaleur qu'elle perd réchauffe l'air
+			- la résistance chauffe l'eau (heaterPower watts dans waterCapacity joules par degré)
+			- une part ledHeatShare de la puissance des LEDs chauffe l'air (airCapacity joules par degré)
+			- l'humidité tend vers celle de la pièce, l'arrosage y ajoute evaporation pourcents par seconde
+		Les températures et l'humidité calculées sont celles que lisent les capteurs simulés
+
+		La qualité de la régulation est mesurée sur les consignes que le firmware applique:
+			- la part du temps passée dans la plage (basse..haute) de l'air et de l'eau
+			- les dépassements maximaux au-dessus et en dessous de la plage, une fois celle-ci atteinte une première fois
+			- le nombre de cycles des relais et du ventilateur ramené à une journée
+			- l'énergie consommée par la résistance, les LEDs, le ventilateur et la pompe
+*/
+
+#include <Greenhouse.h>
+
+// Table des paramètres modifiables par leur nom
+const Greenhouse::Parameter Greenhouse::parameters[] = {
+	{"startHour", &Greenhouse::startHour},
+	{"ambientMean", &Greenhouse::ambientMean},
+	{"ambientSwing", &Greenhouse::ambientSwing},
+	{"ambientPeakHour", &Greenhouse::ambientPeakHour},
+	{"humidityMean", &Greenhouse::humidityMean},
+	{"humiditySwing", &Greenhouse::humiditySwing},
+	{"airTau", &Greenhouse::airTau},
+	{"airFanTau", &Greenhouse::airFanTau},
+	{"airCapacity", &Greenhouse::airCapacity},
+	{"waterTau", &Greenhouse::waterTau},
+	{"waterCapacity", &Greenhouse::waterCapacity},
+	{"heaterPower", &Greenhouse::heaterPower},
+	{"ledPower", &Greenhouse::ledPower},
+	{"ledHeatShare", &Greenhouse::ledHeatShare},
+	{"fanPower", &Greenhouse::fanPower},
+	{"pumpPower", &Greenhouse::pumpPower},
+	{"evaporation", &Greenhouse::evaporation},
+	{"timerTop", &Greenhouse::timerTop},
+	{NULL, NULL}
+};
+
+// Constructeur de la classe Greenhouse
+// Les valeurs par défaut décrivent une petite unité (10 litres d'eau, résistance d'aquarium de 50 W, 40 W de LEDs) dans une pièce à 18°C
+//
+Greenhouse::Greenhouse(){
+	startHour = 0;
+	ambientMean = 18;
+	ambientSwing = 3;
+	ambientPeakHour = 15;
+	humidityMean = 55;
+	humiditySwing = 10;
+	airTau = 1800;
+	airFanTau = 300;
+	airCapacity = 20000;
+	waterTau = 7200;
+	waterCapacity = 41868;
+	heaterPower = 50;
+	ledPower = 40;
+	ledHeatShare = 0.7;
+	fanPower = 3;
+	pumpPower = 5;
+	evaporation = 0.01;
+	timerTop = 207;
+
+	lastStep = 0;
+	for(uint8_t i = 0; i < 4; i++) bands[i] = NULL;
+	memset(&airScore, 0, sizeof(airScore));
+	memset(&waterScore, 0, sizeof(waterScore));
+	seconds = 0;
+	heaterCycles = pumpCycles = fanCycles = 0;
+	wasHeaterOn = wasPumpOn = wasFanOn = false;
+	heaterEnergy = ledEnergy = fanEnergy = pumpEnergy = 0;
+
+	// Au départ, l'air et l'eau sont à la température de la pièce
+	updateAmbient();
+	airTemperature = waterTemperature = ambientTemperature;
+	airHumidity = ambientHumidity;
+	publish();
+}
+
+// Méthode modifiant un paramètre du modèle
+// Retourne false si le paramètre n'existe pas
+//	- name: le nom du paramètre
+//	- value: sa nouvelle valeur
+//
+bool Greenhouse::setParameter(const char* name, float value){
+	for(const Parameter* parameter = parameters; parameter->name != NULL; parameter++){
+		if(strcmp(parameter->name, name) == 0){
+			this->*(parameter->value) = value;
+			if(strcmp(name, "startHour") == 0 || strncmp(name, "ambient", 7) == 0 || strncmp(name, "humidity", 8) == 0){
+				updateAmbient();
+				airTemperature = waterTemperature = ambientTemperature;
+				airHumidity = ambientHumidity;
+				publish();
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+// Méthode indiquant où lire les consignes du firmware, pour mesurer la qualité de la régulation
+// Les consignes sont en virgule fixe Q7 (1/128 de degré), INT16_MIN tant que le programme n'est pas chargé:
+// la mesure est alors suspendue
+//
+void Greenhouse::watchBands(const int16_t* airLow, const int16_t* airHigh, const int16_t* waterLow, const int16_t* waterHigh){
+	bands[0] = airLow;
+	bands[1] = airHigh;
+	bands[2] = waterLow;
+	bands[3] = waterHigh;
+}
+
+// Méthode appelée à chaque avance de l'horloge virtuelle, qui intègre le modèle jusqu'à l'heure donnée
+//	- now: l'heure virtuelle en microseconde
+//
+void Greenhouse::update(uint64_t now){
+	while(now - lastStep >= GREENHOUSE_STEP * 1000000ULL){
+		lastStep += GREENHOUSE_STEP * 1000000ULL;
+		step();
+	}
+}
+
+// Méthode écrivant les mesures de la qualité de la régulation, une ligne SIM:NOM=valeur par mesure
+//	- file: le flux de sortie
+//
+void Greenhouse::report(FILE* file){
+	float days = seconds / 86400;
+	fprintf(file, "SIM:HOURS=%.2f\n", seconds / 3600);
+	printScore(file, "AIR", &airScore);
+	printScore(file, "WATER", &waterScore);
+	if(days > 0){
+		fprintf(file, "SIM:HEATER_CYCLES_PER_DAY=%.1f\n", heaterCycles / days);
+		fprintf(file, "SIM:PUMP_CYCLES_PER_DAY=%.1f\n", pumpCycles / days);
+		fprintf(file, "SIM:FAN_CYCLES_PER_DAY=%.1f\n", fanCycles / days);
+	}
+	fprintf(file, "SIM:HEATER_WH=%.1f\n", heaterEnergy);
+	fprintf(file, "SIM:LED_WH=%.1f\n", ledEnergy);
+	fprintf(file, "SIM:FAN_WH=%.1f\n", fanEnergy);
+	fprintf(file, "SIM:PUMP_WH=%.1f\n", pumpEnergy);
+	if(days > 0) fprintf(file, "SIM:KWH_PER_DAY=%.3f\n", (heaterEnergy + ledEnergy + fanEnergy + pumpEnergy) / 1000 / days);
+}
+
+// Méthode privée intégrant le modèle sur un pas
+//
+void Greenhouse::step(){
+	const float dt = GREENHOUSE_STEP;
+
+	// Lecture des sorties du firmware: les relais sont actifs à l'état bas
+	bool isHeaterOn = Hal::pinModes[GREENHOUSE_HEAT_PIN] == OUTPUT && Hal::digitalLevels[GREENHOUSE_HEAT_PIN] == LOW;
+	bool isPumpOn = Hal::pinModes[GREENHOUSE_PUMP_PIN] == OUTPUT && Hal::digitalLevels[GREENHOUSE_PUMP_PIN] == LOW;
+	float fan = constrain(Hal::analogOutputs[GREENHOUSE_FAN_PIN] / 255.0, 0.0, 1.0);
+	float led = (constrain(Hal::analogOutputs[GREENHOUSE_R_PIN] / timerTop, 0.0, 1.0)
+		+ constrain(Hal::analogOutputs[GREENHOUSE_G_PIN] / timerTop, 0.0, 1.0)
+		+ constrain(Hal::analogOutputs[GREENHOUSE_B_PIN] / 255.0, 0.0, 1.0)) / 3;
+
+	// Evolution des températures et de l'humidité
+	updateAmbient();
+	float exchange = 1 / airTau + fan / airFanTau;
+	float waterLoss = (waterTemperature - airTemperature) / waterTau;
+	waterTemperature += (-waterLoss + (isHeaterOn ? heaterPower / waterCapacity : 0)) * dt;
+	airTemperature += ((ambientTemperature - airTemperature) * exchange
+		+ waterLoss * waterCapacity / airCapacity
+		+ led * ledPower * ledHeatShare / airCapacity) * dt;
+	airHumidity += ((ambientHumidity - airHumidity) * exchange + (isPumpOn ? evaporation : 0)) * dt;
+	airHumidity = constrain(airHumidity, 0.0, 100.0);
+
+	// Les capteurs simulés lisent le nouvel état
+	publish();
+
+	// Mesures
+	seconds += dt;
+	score(&airScore, airTemperature, bands[0], bands[1]);
+	score(&waterScore, waterTemperature, bands[2], bands[3]);
+	countCycle(isHeaterOn, &wasHeaterOn, &heaterCycles);
+	countCycle(isPumpOn, &wasPumpOn, &pumpCycles);
+	countCycle(fan > 0, &wasFanOn, &fanCycles);
+	heaterEnergy += (isHeaterOn ? heaterPower : 0) * dt / 3600;
+	ledEnergy += led * ledPower * dt / 3600;
+	fanEnergy += fan * fanPower * dt / 3600;
+	pumpEnergy += (isPumpOn ? pumpPower : 0) * dt / 3600;
+}
+
+// Méthode privée calculant la température et l'humidité de la pièce à l'heure virtuelle courante
+// L'humidité est au plus bas quand la température est au plus haut
+//
+void Greenhouse::updateAmbient(){
+	float hour = startHour + lastStep / 3600e6;
+	float phase = cos(2 * M_PI * (hour - ambientPeakHour) / 24);
+	ambientTemperature = ambientMean + ambientSwing * phase;
+	ambientHumidity = humidityMean - humiditySwing * phase;
+}
+
+// Méthode privée transmettant l'état du modèle aux capteurs simulés
+//
+void Greenhouse::publish(){
+	Hal::airTemperature = airTemperature;
+	Hal::airHumidity = airHumidity;
+	Hal::waterTemperature = waterTemperature;
+}
+
+// Méthode privée mesurant la position d'une valeur par rapport à sa plage de consigne
+//
+void Greenhouse::score(Score* score, float value, const int16_t* lowBand, const int16_t* highBand){
+	if(lowBand == NULL || highBand == NULL || *lowBand == INT16_MIN || *highBand == INT16_MIN) return;
+	float low = *lowBand / 128.0;
+	float high = *highBand / 128.0;
+	score->seconds += GREENHOUSE_STEP;
+	if(value >= low && value <= high){
+		score->inBand += GREENHOUSE_STEP;
+		score->hasReachedBand = true;
+	}
+	else if(score->hasReachedBand){
+		score->overshoot = max(score->overshoot, value - high);
+		score->undershoot = max(score->undershoot, low - value);
+	}
+}
+
+// Méthode privée écrivant les mesures d'une plage de consigne
+//
+void Greenhouse::printScore(FILE* file, const char* name, const Score* score){
+	if(score->seconds == 0) return;
+	fprintf(file, "SIM:%s_IN_BAND=%.1f\n", name, 100 * score->inBand / score->seconds);
+	fprintf(file, "SIM:%s_OVERSHOOT=%.2f\n", name, score->overshoot);
+	fprintf(file, "SIM:%s_UNDERSHOOT=%.2f\n", name, score->undershoot);
+}
+
+// Méthode privée comptant un cycle à chaque mise en marche
+//
+void Greenhouse::countCycle(bool state, bool* previous, unsigned long* cycles){
+	if(state && !*previous) (*cycles)++;
+	*previous = state;
+}
@@ -0,0 +1,101 @@
+/*
+		Greenhouse.h - Modèle thermique de l'unité de germination et mesure de la qualité de la régulation (environnement native)
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+*/
+
+#ifndef Greenhouse_h
+#define Greenhouse_h
+
+#include <Arduino.h>
+
+// Broches de la carte lues par le modèle, identiques à celles de runtime.cpp
+#define GREENHOUSE_R_PIN 9
+#define GREENHOUSE_G_PIN 10
+#define GREENHOUSE_B_PIN 11
+#define GREENHOUSE_FAN_PIN 6
+#define GREENHOUSE_HEAT_PIN 2
+#define GREENHOUSE_PUMP_PIN 12
+
+// Pas d'intégration du modèle, en secondes de temps virtuel
+#define GREENHOUSE_STEP 1
+
+class Greenhouse{
+
+	public:
+		Greenhouse();
+
+		bool setParameter(const char* name, float value);
+		void watchBands(const int16_t* airLow, const int16_t* airHigh, const int16_t* waterLow, const int16_t* waterHigh);
+		void update(uint64_t now);
+		void report(FILE* file);
+
+	private:
+		typedef struct{
+			const char* name;
+			float Greenhouse::* value;
+		} Parameter;
+
+		typedef struct{
+			float seconds;
+			float inBand;
+			float overshoot;
+			float undershoot;
+			bool hasReachedBand;
+		} Score;
+
+		static const Parameter parameters[];
+
+		// Paramètres du modèle, modifiables par setParameter()
+		float startHour;
+		float ambientMean;
+		float ambientSwing;
+		float ambientPeakHour;
+		float humidityMean;
+		float humiditySwing;
+		float airTau;
+		float airFanTau;
+		float airCapacity;
+		float waterTau;
+		float waterCapacity;
+		float heaterPower;
+		float ledPower;
+		float ledHeatShare;
+		float fanPower;
+		float pumpPower;
+		float evaporation;
+		float timerTop;
+
+		// Etat du modèle
+		uint64_t lastStep;
+		float ambientTemperature;
+		float ambientHumidity;
+		float airTemperature;
+		float airHumidity;
+		float waterTemperature;
+
+		// Mesures de la régulation
+		const int16_t* bands[4];
+		Score airScore;
+		Score waterScore;
+		float seconds;
+		unsigned long heaterCycles;
+		unsigned long pumpCycles;
+		unsigned long fanCycles;
+		bool wasHeaterOn;
+		bool wasPumpOn;
+		bool wasFanOn;
+		float heaterEnergy;
+		float ledEnergy;
+		float fanEnergy;
+		float pumpEnergy;
+
+		void step();
+		void updateAmbient();
+		void publish();
+		void score(Score* score, float value, const int16_t* lowBand, const int16_t* highBand);
+		void printScore(FILE* file, const char* name, const Score* score);
+		static void countCycle(bool state, bool* previous, unsigned long* cycles);
+};
+
+#endif
@@ -0,0 +1,216 @@
+/*
+		Arduino.cpp - Implémentation de l'API Arduino de l'environnement native
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Chaque fonction lit ou modifie l'état de la carte simulée conservé par la classe Hal
+*/
+
+#include <Arduino.h>
+
+HardwareSerial Serial;
+
+// Fonction retournant le nombre de millisecondes écoulées depuis le démarrage sur l'horloge virtuelle
+//
+unsigned long millis(){
+	Hal::advance(HAL_POLL_COST);
+	return Hal::getMicros() / 1000;
+}
+
+// Fonction retournant le nombre de microsecondes écoulées depuis le démarrage sur l'horloge virtuelle
+//
+unsigned long micros(){
+	Hal::advance(HAL_POLL_COST);
+	return Hal::getMicros();
+}
+
+// Procédure qui fait avancer l'horloge virtuelle du nombre de millisecondes donné
+//
+void delay(unsigned long ms){
+	Hal::advance((uint64_t)ms * 1000);
+}
+
+// Procédure qui fait avancer l'horloge virtuelle du nombre de microsecondes donné
+//
+void delayMicroseconds(unsigned int us){
+	Hal::advance(us);
+}
+
+// Procédures sans effet: aucune interruption ne vient perturber la simulation
+//
+void noInterrupts(){}
+void interrupts(){}
+
+// Procédure mémorisant le mode d'une broche, une entrée avec résistance de tirage est lue à l'état haut
+//
+void pinMode(uint8_t pin, uint8_t mode){
+	if(pin >= HAL_DIGITAL_PINS) return;
+	Hal::pinModes[pin] = mode;
+	if(mode == INPUT_PULLUP) Hal::digitalLevels[pin] = HIGH;
+}
+
+// Procédure mémorisant le niveau d'une broche, vu comme une valeur PWM de 0 ou 255
+//
+void digitalWrite(uint8_t pin, uint8_t level){
+	if(pin >= HAL_DIGITAL_PINS) return;
+	Hal::digitalLevels[pin] = level ? HIGH : LOW;
+	Hal::analogOutputs[pin] = level ? 255 : 0;
+}
+
+// Fonction retournant le niveau d'une broche, fixé par le firmware ou par la simulation
+//
+int digitalRead(uint8_t pin){
+	if(pin >= HAL_DIGITAL_PINS) return LOW;
+	return Hal::digitalLevels[pin];
+}
+
+// Procédure mémorisant la valeur PWM d'une broche, comme analogWrite() elle passe la broche en sortie
+//
+void analogWrite(uint8_t pin, int value){
+	if(pin >= HAL_DIGITAL_PINS) return;
+	Hal::pinModes[pin] = OUTPUT;
+	Hal::analogOutputs[pin] = value;
+	Hal::digitalLevels[pin] = value > 0 ? HIGH : LOW;
+}
+
+// Fonction retournant la valeur d'une entrée analogique, donnée sous son numéro (0) ou sous son nom de broche (A0 = 14)
+//
+int analogRead(uint8_t pin){
+	if(pin >= 14) pin -= 14;
+	if(pin >= HAL_ANALOG_PINS) return 0;
+	return Hal::analogInputs[pin];
+}
+
+// Fonction convertissant un flottant en texte, comme celle de la libc AVR
+//
+char* dtostrf(double value, signed char width, unsigned char precision, char* buffer){
+	sprintf(buffer, "%*.*f", width, precision, value);
+	return buffer;
+}
+
+// Méthodes d'écriture de la classe Print, qui produisent le même texte que celles du framework Arduino
+// Toutes se ramènent à la méthode write(uint8_t) de la classe dérivée
+//
+size_t Print::write(const char* text){
+	return write((const uint8_t*)text, strlen(text));
+}
+
+size_t Print::write(const uint8_t* buffer, size_t length){
+	size_t count = 0;
+	while(length--) count += write(*buffer++);
+	return count;
+}
+
+size_t Print::print(const char* text){
+	return write(text);
+}
+
+size_t Print::print(const __FlashStringHelper* text){
+	return write((const char*)text);
+}
+
+size_t Print::print(char c){
+	return write((uint8_t)c);
+}
+
+size_t Print::print(int value, int base){
+	return print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base){
+	return print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base){
+	if(base == DEC && value < 0) return print('-') + print((unsigned long)-value, base);
+	return print((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base){
+	char buffer[8 * sizeof(long) + 1];
+	char* digit = &buffer[sizeof(buffer) - 1];
+	*digit = '\0';
+	if(base < 2) base = DEC;
+	do{
+		uint8_t remainder = value % base;
+		*--digit = remainder < 10 ? '0' + remainder : 'A' + remainder - 10;
+		value /= base;
+	} while(value);
+	return write(digit);
+}
+
+size_t Print::print(double value, int digits){
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+	return write(buffer);
+}
+
+size_t Print::println(){
+	return write("\r\n");
+}
+
+size_t Print::println(const char* text){
+	return print(text) + println();
+}
+
+size_t Print::println(const __FlashStringHelper* text){
+	return print(text) + println();
+}
+
+size_t Print::println(char c){
+	return print(c) + println();
+}
+
+size_t Print::println(int value, int base){
+	return print(value, base) + println();
+}
+
+size_t Print::println(unsigned int value, int base){
+	return print(value, base) + println();
+}
+
+size_t Print::println(long value, int base){
+	return print(value, base) + println();
+}
+
+size_t Print::println(unsigned long value, int base){
+	return print(value, base) + println();
+}
+
+size_t Print::println(double value, int digits){
+	return print(value, digits) + println();
+}
+
+// Méthodes du port série, qui lisent les lignes programmées et écrivent sur la sortie standard au travers de Hal
+// La vitesse n'a pas de sens sur le PC: les octets émis sont écrits immédiatement
+//
+void HardwareSerial::begin(unsigned long speed){}
+
+int HardwareSerial::available(){
+	return Hal::countReceived();
+}
+
+int HardwareSerial::read(){
+	return Hal::receive();
+}
+
+int HardwareSerial::peek(){
+	return Hal::peekReceived();
+}
+
+size_t HardwareSerial::write(uint8_t byte){
+	Hal::transmit(byte);
+	return 1;
+}
+
+int HardwareSerial::availableForWrite(){
+	return SERIAL_TX_BUFFER_SIZE - 1;
+}
+
+void HardwareSerial::flush(){
+	fflush(stdout);
+}
+
+HardwareSerial::operator bool(){
+	return true;
+}
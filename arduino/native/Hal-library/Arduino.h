@@ -0,0 +1,130 @@
+/*
+		Arduino.h - API Arduino de l'environnement native, implémentée au-dessus de la couche d'abstraction Hal
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+*/
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <Hal.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// ARDUINO est aussi passé en option de compilation (platformio.ini), les librairies le testent avant d'inclure ce fichier
+#ifndef ARDUINO
+#define ARDUINO 100
+#endif
+#define F_CPU 16000000UL
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define DEC 10
+#define HEX 16
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(amount, low, high) ((amount) < (low) ? (low) : ((amount) > (high) ? (high) : (amount)))
+
+// La mémoire programme et la mémoire de données ne font qu'une sur le PC
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_dword(address) (*(const uint32_t*)(address))
+#define pgm_read_ptr(address) (*(void* const*)(address))
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define memcpy_P memcpy
+#define snprintf_P snprintf
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(PSTR(s)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void noInterrupts();
+void interrupts();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+int analogRead(uint8_t pin);
+
+char* dtostrf(double value, signed char width, unsigned char precision, char* buffer);
+
+class Print{
+
+	public:
+		virtual ~Print(){}
+		virtual size_t write(uint8_t byte) = 0;
+		size_t write(const char* text);
+		size_t write(const uint8_t* buffer, size_t length);
+
+		size_t print(const char* text);
+		size_t print(const __FlashStringHelper* text);
+		size_t print(char c);
+		size_t print(int value, int base = DEC);
+		size_t print(unsigned int value, int base = DEC);
+		size_t print(long value, int base = DEC);
+		size_t print(unsigned long value, int base = DEC);
+		size_t print(double value, int digits = 2);
+
+		size_t println();
+		size_t println(const char* text);
+		size_t println(const __FlashStringHelper* text);
+		size_t println(char c);
+		size_t println(int value, int base = DEC);
+		size_t println(unsigned int value, int base = DEC);
+		size_t println(long value, int base = DEC);
+		size_t println(unsigned long value, int base = DEC);
+		size_t println(double value, int digits = 2);
+};
+
+class Stream : public Print{
+
+	public:
+		virtual int available() = 0;
+		virtual int read() = 0;
+		virtual int peek() = 0;
+};
+
+// Port série relié à l'entrée programmée et à la sortie standard de la simulation
+// Le tampon d'émission n'est jamais plein: l'émission est instantanée sur le PC
+//
+#define SERIAL_TX_BUFFER_SIZE 64
+
+class HardwareSerial : public Stream{
+
+	public:
+		void begin(unsigned long speed);
+		virtual int available();
+		virtual int read();
+		virtual int peek();
+		virtual size_t write(uint8_t byte);
+		using Print::write;
+		int availableForWrite();
+		void flush();
+		operator bool();
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,213 @@
+/*
+		DHT.cpp - Implémentation du capteur de température et d'humidité de l'air simulé
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Les valeurs de Hal::airTemperature et Hal::airHumidity sont codées dans les cinq octets d'une trame,
+		comme le ferait le capteur, puis décodées avec les formules de la librairie d'origine:
+		un DHT11 ne donne donc que des degrés et des pourcents entiers, un DHT22 des dixièmes
+		La lecture asynchrone dure DHT_READ_TIME millisecondes de temps virtuel
+*/
+
+#include <DHT.h>
+
+// Constructeur de la classe DHT
+//	- pin: la broche de données du capteur
+//	- type: le type de capteur (DHT11, DHT22 ou DHT21)
+//
+DHT::DHT(uint8_t pin, uint8_t type, uint8_t count){
+	this->pin = pin;
+	this->type = type;
+	isFirstRead = true;
+	isBusyReading = false;
+	ready = false;
+	lastResult = false;
+}
+
+// Méthode préparant la broche de données
+//
+void DHT::begin(void){
+	pinMode(pin, INPUT_PULLUP);
+	isFirstRead = true;
+}
+
+// Méthode effectuant une lecture bloquante
+// Retourne false si le capteur est déconnecté
+//	- force: true pour ignorer l'intervalle minimal entre deux lectures
+//
+boolean DHT::read(bool force){
+	unsigned long now = millis();
+	if(!force && !isFirstRead && now - lastReadTime < DHT_MIN_INTERVAL) return lastResult;
+	isFirstRead = false;
+	lastReadTime = now;
+	delay(DHT_READ_TIME);
+	sample();
+	return lastResult;
+}
+
+// Méthodes de lecture bloquante de la température et de l'humidité, NAN si le capteur est déconnecté
+//
+float DHT::readTemperature(bool S, bool force){
+	return read(force) ? convertTemperature(S) : NAN;
+}
+
+float DHT::readHumidity(bool force){
+	return read(force) ? convertHumidity() : NAN;
+}
+
+// Méthodes de conversion entre degrés Celsius et Fahrenheit
+//
+float DHT::convertCtoF(float c){
+	return c * 1.8 + 32;
+}
+
+float DHT::convertFtoC(float f){
+	return (f - 32) * 0.55555;
+}
+
+// Méthode démarrant une lecture asynchrone
+// Retourne false si une lecture est en cours ou si la précédente est trop récente
+//	- force: true pour ignorer l'intervalle minimal entre deux lectures
+//
+bool DHT::startRead(bool force){
+	unsigned long now = millis();
+	if(isBusyReading) return false;
+	if(!force && !isFirstRead && now - lastReadTime < DHT_MIN_INTERVAL) return false;
+	isFirstRead = false;
+	lastReadTime = now;
+	ready = false;
+	isBusyReading = true;
+	return true;
+}
+
+// Méthode dirigeant le lecteur vers le capteur d'une autre broche, éventuellement d'un autre type
+// Tous les capteurs simulés mesurent le même air; retourne false si une lecture est en cours
+//	- pin: la broche de données du capteur
+//	- type: le type de capteur (DHT11, DHT22 ou DHT21)
+//
+bool DHT::setSensor(uint8_t pin, uint8_t type){
+	if(isBusyReading) return false;
+	this->pin = pin;
+	this->type = type;
+	ready = false;
+	lastResult = false;
+	isFirstRead = true;
+	pinMode(pin, INPUT_PULLUP);
+	return true;
+}
+
+// Méthode à appeler à chaque itération, qui termine la lecture asynchrone une fois sa durée écoulée
+//
+void DHT::update(void){
+	if(isBusyReading && millis() - lastReadTime >= DHT_READ_TIME){
+		sample();
+		isBusyReading = false;
+		ready = true;
+	}
+}
+
+// Méthode retournant true quand la lecture asynchrone a un résultat à collecter
+//
+bool DHT::isReady(void){
+	return ready;
+}
+
+// Méthode retournant true pendant une lecture asynchrone
+//
+bool DHT::isBusy(void){
+	return isBusyReading;
+}
+
+// Méthodes retournant la température et l'humidité de la dernière lecture, NAN si elle a échoué
+//
+float DHT::getTemperature(bool S){
+	return lastResult ? convertTemperature(S) : NAN;
+}
+
+float DHT::getHumidity(void){
+	return lastResult ? convertHumidity() : NAN;
+}
+
+// Méthodes retournant la température et l'humidité de la dernière lecture en 1/128 de degré ou de pour cent,
+// DHT_FIXED_INVALID si elle a échoué; décodage entier identique à celui de la librairie de la carte
+//
+int16_t DHT::getFixedTemperature(void){
+	if(!lastResult) return DHT_FIXED_INVALID;
+	if(type == DHT11) return (int16_t)data[2] << 7;
+	int32_t tenths = ((int32_t)(data[2] & 0x7F) << 8) | data[3];
+	tenths = (tenths * 64 + 2) / 5;
+	return data[2] & 0x80 ? -tenths : tenths;
+}
+
+int16_t DHT::getFixedHumidity(void){
+	if(!lastResult) return DHT_FIXED_INVALID;
+	if(type == DHT11) return (int16_t)data[0] << 7;
+	return ((((int32_t)data[0] << 8) | data[1]) * 64 + 2) / 5;
+}
+
+// Méthodes retournant les mots bruts de la dernière trame: octet entier puis octet décimal
+//
+uint16_t DHT::getRawTemperature(void){
+	return ((uint16_t)data[2] << 8) | data[3];
+}
+
+uint16_t DHT::getRawHumidity(void){
+	return ((uint16_t)data[0] << 8) | data[1];
+}
+
+// Méthode privée codant les valeurs simulées dans une trame du capteur
+//
+void DHT::sample(){
+	lastResult = Hal::isAirConnected;
+	if(!lastResult) return;
+	float temperature = Hal::airTemperature;
+	float humidity = constrain(Hal::airHumidity, 0.0, 100.0);
+	if(type == DHT11){
+		data[0] = (uint8_t)humidity;
+		data[1] = 0;
+		data[2] = (uint8_t)constrain(temperature, 0.0, 50.0);
+		data[3] = 0;
+	}
+	else{
+		uint16_t tenths = (uint16_t)lround(fabs(temperature) * 10);
+		uint16_t humidityTenths = (uint16_t)lround(humidity * 10);
+		data[0] = humidityTenths >> 8;
+		data[1] = humidityTenths & 0xFF;
+		data[2] = (tenths >> 8) | (temperature < 0 ? 0x80 : 0);
+		data[3] = tenths & 0xFF;
+	}
+	data[4] = data[0] + data[1] + data[2] + data[3];
+}
+
+// Méthode privée décodant la température, formules de la librairie d'origine
+//
+float DHT::convertTemperature(bool S){
+	float f = NAN;
+	switch(type){
+		case DHT11:
+			f = data[2];
+			break;
+		case DHT22:
+		case DHT21:
+			f = ((data[2] & 0x7F) * 256 + data[3]) * 0.1;
+			if(data[2] & 0x80) f *= -1;
+			break;
+	}
+	return S ? convertCtoF(f) : f;
+}
+
+// Méthode privée décodant l'humidité, formules de la librairie d'origine
+//
+float DHT::convertHumidity(){
+	float f = NAN;
+	switch(type){
+		case DHT11:
+			f = data[0];
+			break;
+		case DHT22:
+		case DHT21:
+			f = (data[0] * 256 + data[1]) * 0.1;
+			break;
+	}
+	return f;
+}
@@ -0,0 +1,64 @@
+/*
+		DHT.h - Capteur de température et d'humidité de l'air simulé pour l'environnement native
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Même interface que la librairie DHT d'Adafruit utilisée sur la carte
+*/
+
+#ifndef DHT_H
+#define DHT_H
+
+#include <Arduino.h>
+
+// Types de capteurs
+#define DHT11 11
+#define DHT22 22
+#define DHT21 21
+#define AM2301 21
+
+// Intervalle minimal entre deux lectures et durée d'une lecture asynchrone (signal de départ et capture), en millisecondes
+#define DHT_MIN_INTERVAL 2000
+#define DHT_READ_TIME 25
+
+// Valeur retournée par les lectures en virgule fixe quand la dernière lecture a échoué
+#define DHT_FIXED_INVALID INT16_MIN
+
+class DHT{
+
+	public:
+		DHT(uint8_t pin, uint8_t type, uint8_t count = 6);
+		void begin(void);
+		float readTemperature(bool S = false, bool force = false);
+		float readHumidity(bool force = false);
+		boolean read(bool force = false);
+		float convertCtoF(float c);
+		float convertFtoC(float f);
+
+		bool startRead(bool force = false);
+		bool setSensor(uint8_t pin, uint8_t type);
+		void update(void);
+		bool isReady(void);
+		bool isBusy(void);
+		float getTemperature(bool S = false);
+		float getHumidity(void);
+		int16_t getFixedTemperature(void);
+		int16_t getFixedHumidity(void);
+		uint16_t getRawTemperature(void);
+		uint16_t getRawHumidity(void);
+
+	private:
+		uint8_t data[5];
+		uint8_t pin;
+		uint8_t type;
+		unsigned long lastReadTime;
+		bool isFirstRead;
+		bool isBusyReading;
+		bool ready;
+		bool lastResult;
+		void sample();
+		float convertTemperature(bool S);
+		float convertHumidity();
+};
+
+#endif
@@ -0,0 +1,147 @@
+/*
+		DallasTemperature.cpp - Implémentation de la sonde de température DS18B20 simulée
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Une conversion capture Hal::waterTemperature au moment de la demande, au pas de la résolution courante
+		(0,5°C à 9 bits jusqu'à 0,0625°C à 12 bits), et ne remplace le contenu du scratchpad
+		qu'une fois la durée de conversion de la résolution écoulée, comme sur la sonde
+*/
+
+#include <DallasTemperature.h>
+
+// Constructeurs de la classe DallasTemperature
+//
+DallasTemperature::DallasTemperature(){
+	wire = NULL;
+	bitResolution = 12;
+	waitForConversion = true;
+	scratchpad = 85 * 16;
+	isConverting = false;
+}
+
+DallasTemperature::DallasTemperature(OneWire* wire) : DallasTemperature(){
+	this->wire = wire;
+}
+
+void DallasTemperature::setOneWire(OneWire* wire){
+	this->wire = wire;
+}
+
+// Méthode initialisant la sonde, qui démarre comme une DS18B20 à 12 bits avec 85°C dans son scratchpad
+//
+void DallasTemperature::begin(void){
+	scratchpad = 85 * 16;
+	isConverting = false;
+}
+
+// Méthode recherchant à nouveau les sondes sur le bus, qui retourne leur nombre
+// La sonde simulée garde son scratchpad: seul un démarrage le remet à 85°C
+//
+uint8_t DallasTemperature::rescan(void){
+	return getDeviceCount();
+}
+
+// Méthode retournant le nombre de sondes présentes sur le bus
+//
+uint8_t DallasTemperature::getDeviceCount(void){
+	return Hal::isWaterConnected ? 1 : 0;
+}
+
+// Méthodes de lecture et de réglage de la résolution (9 à 12 bits)
+// La sonde simulée n'a pas d'EEPROM: save est sans effet
+//
+uint8_t DallasTemperature::getResolution(){
+	return bitResolution;
+}
+
+void DallasTemperature::setResolution(uint8_t resolution, bool save){
+	bitResolution = constrain(resolution, 9, 12);
+}
+
+// Méthodes de lecture et de réglage de l'attente de la fin de conversion par requestTemperatures()
+//
+void DallasTemperature::setWaitForConversion(bool flag){
+	waitForConversion = flag;
+}
+
+bool DallasTemperature::getWaitForConversion(void){
+	return waitForConversion;
+}
+
+// Méthode demandant une conversion, bloquante si l'attente de fin de conversion est activée
+//
+void DallasTemperature::requestTemperatures(void){
+	converting = sample();
+	conversionEnd = millis() + millisToWaitForConversion(bitResolution);
+	isConverting = true;
+	if(waitForConversion) delay(millisToWaitForConversion(bitResolution));
+}
+
+// Méthode retournant true quand la conversion en cours est terminée
+//
+bool DallasTemperature::isConversionComplete(void){
+	if(isConverting && (long)(millis() - conversionEnd) >= 0){
+		scratchpad = converting;
+		isConverting = false;
+	}
+	return !isConverting;
+}
+
+// Méthode retournant la durée de conversion en millisecondes pour une résolution, valeurs de la fiche technique
+//
+int16_t DallasTemperature::millisToWaitForConversion(uint8_t resolution){
+	switch(resolution){
+		case 9:
+			return 94;
+		case 10:
+			return 188;
+		case 11:
+			return 375;
+		default:
+			return 750;
+	}
+}
+
+// Méthode retournant la température lue dans le scratchpad, DEVICE_DISCONNECTED_C si la sonde est absente
+//
+float DallasTemperature::getTempCByIndex(uint8_t index){
+	if(index > 0 || !Hal::isWaterConnected) return DEVICE_DISCONNECTED_C;
+	isConversionComplete();
+	return scratchpad * 0.0625;
+}
+
+// Méthode retournant la température brute lue dans le scratchpad, en 1/128 de degré comme la librairie de la carte
+// Retourne DEVICE_DISCONNECTED_RAW si la sonde est absente
+//
+int16_t DallasTemperature::getTempByIndex(uint8_t index){
+	if(index > 0 || !Hal::isWaterConnected) return DEVICE_DISCONNECTED_RAW;
+	isConversionComplete();
+	return scratchpad << 3;
+}
+
+// Méthode retournant l'adresse de la sonde de rang index sur le bus, false si elle est absente
+// La sonde simulée a une adresse fixe de la famille DS18B20
+//
+bool DallasTemperature::getAddress(uint8_t* address, uint8_t index){
+	if(index >= getDeviceCount()) return false;
+	static const uint8_t simulated[8] = { DS18B20MODEL, 0x53, 0x49, 0x4D, 0x00, 0x00, 0x00, 0x00 };
+	memcpy(address, simulated, 8);
+	address[7] = OneWire::crc8(address, 7);
+	return true;
+}
+
+// Méthode retournant la température brute de la sonde d'adresse donnée, en 1/128 de degré
+// Retourne DEVICE_DISCONNECTED_RAW si la sonde est absente
+//
+int16_t DallasTemperature::getTemp(const uint8_t* address){
+	if(address[0] != DS18B20MODEL) return DEVICE_DISCONNECTED_RAW;
+	return getTempByIndex(0);
+}
+
+// Méthode privée retournant la température simulée en seizièmes de degré, tronquée à la résolution courante
+//
+int16_t DallasTemperature::sample(){
+	int16_t raw = (int16_t)floor(Hal::waterTemperature * 16);
+	return raw & ~((1 << (12 - bitResolution)) - 1);
+}
@@ -0,0 +1,57 @@
+/*
+		DallasTemperature.h - Sonde de température DS18B20 simulée pour l'environnement native
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Même interface que la partie de la librairie DallasTemperature utilisée par le firmware
+*/
+
+#ifndef DallasTemperature_h
+#define DallasTemperature_h
+
+#include <Arduino.h>
+#include <OneWire.h>
+
+#define DS18B20MODEL 0x28
+
+// Codes d'erreur
+#define DEVICE_DISCONNECTED_C -127
+#define DEVICE_DISCONNECTED_F -196.6
+#define DEVICE_DISCONNECTED_RAW -7040
+
+typedef uint8_t DeviceAddress[8];
+
+class DallasTemperature{
+
+	public:
+		DallasTemperature();
+		DallasTemperature(OneWire* wire);
+
+		void setOneWire(OneWire* wire);
+		void begin(void);
+		uint8_t rescan(void);
+		uint8_t getDeviceCount(void);
+		uint8_t getResolution();
+		void setResolution(uint8_t resolution, bool save = true);
+		void setWaitForConversion(bool flag);
+		bool getWaitForConversion(void);
+		void requestTemperatures(void);
+		bool isConversionComplete(void);
+		int16_t millisToWaitForConversion(uint8_t resolution);
+		float getTempCByIndex(uint8_t index);
+		int16_t getTempByIndex(uint8_t index);
+		bool getAddress(uint8_t* address, uint8_t index);
+		int16_t getTemp(const uint8_t* address);
+
+	private:
+		OneWire* wire;
+		uint8_t bitResolution;
+		bool waitForConversion;
+		int16_t scratchpad;
+		int16_t converting;
+		unsigned long conversionEnd;
+		bool isConverting;
+		int16_t sample();
+};
+
+#endif
@@ -0,0 +1,59 @@
+/*
+		EEPROM.h - EEPROM de l'environnement native, conservée dans la classe Hal
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+*/
+
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include <Arduino.h>
+
+class EEPROMClass{
+
+	public:
+
+		// Méthode retournant l'octet conservé à l'adresse donnée
+		//
+		uint8_t read(int address){
+			return Hal::eeprom[address % HAL_EEPROM_SIZE];
+		}
+
+		// Méthode écrivant un octet à l'adresse donnée
+		//
+		void write(int address, uint8_t value){
+			Hal::eeprom[address % HAL_EEPROM_SIZE] = value;
+		}
+
+		// Méthode n'écrivant l'octet que s'il diffère de celui déjà conservé
+		//
+		void update(int address, uint8_t value){
+			if(read(address) != value) write(address, value);
+		}
+
+		// Méthode lisant un objet complet à partir de l'adresse donnée
+		//
+		template<typename T> T& get(int address, T& value){
+			uint8_t* bytes = (uint8_t*)&value;
+			for(size_t i = 0; i < sizeof(T); i++) bytes[i] = read(address + i);
+			return value;
+		}
+
+		// Méthode écrivant un objet complet à partir de l'adresse donnée, seuls les octets modifiés sont réécrits
+		//
+		template<typename T> const T& put(int address, const T& value){
+			const uint8_t* bytes = (const uint8_t*)&value;
+			for(size_t i = 0; i < sizeof(T); i++) update(address + i, bytes[i]);
+			return value;
+		}
+
+		// Méthode retournant la taille de l'EEPROM
+		//
+		uint16_t length(){
+			return HAL_EEPROM_SIZE;
+		}
+};
+
+static EEPROMClass EEPROM;
+
+#endif
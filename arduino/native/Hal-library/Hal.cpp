@@ -0,0 +1,186 @@
+/*
+		Hal.cpp - Implémentation de la couche d'abstraction matérielle de l'environnement native
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Le temps est entièrement virtuel: il n'avance que lorsque la boucle de simulation l'ordonne (voir main.cpp),
+		quand le firmware appelle delay() ou delayMicroseconds(), et d'HAL_POLL_COST microsecondes à chaque lecture de l'horloge
+		Deux exécutions avec les mêmes entrées produisent donc exactement les mêmes sorties, quelle que soit la machine,
+		et des heures de fonctionnement du firmware s'exécutent en quelques millisecondes
+
+		Les types du PC ne sont pas ceux de l'AVR: int fait 32 bits et unsigned long 64 bits,
+		millis() ne repasse donc pas par zéro après 49 jours comme sur la carte
+*/
+
+#include <deque>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include <Hal.h>
+
+typedef struct{
+	uint64_t at;
+	std::vector<uint8_t> bytes;
+} ScheduledInput;
+
+static std::vector<ScheduledInput> inputs;
+static std::deque<uint8_t> received;
+
+uint64_t Hal::now = 0;
+uint64_t Hal::stop = 0;
+Hal::Model Hal::model = NULL;
+bool Hal::isTimestamped = false;
+bool Hal::isLineStart = true;
+bool Hal::isLCDTraced = false;
+
+uint8_t Hal::pinModes[HAL_DIGITAL_PINS];
+uint8_t Hal::digitalLevels[HAL_DIGITAL_PINS];
+int Hal::analogOutputs[HAL_DIGITAL_PINS];
+int Hal::analogInputs[HAL_ANALOG_PINS];
+
+uint8_t Hal::eeprom[HAL_EEPROM_SIZE];
+
+float Hal::airTemperature = 20.0;
+float Hal::airHumidity = 50.0;
+bool Hal::isAirConnected = true;
+float Hal::waterTemperature = 18.0;
+bool Hal::isWaterConnected = true;
+
+// Méthode remettant la carte simulée dans son état de mise sous tension
+// L'EEPROM est vierge comme à la sortie d'usine et aucune ligne n'est en attente sur le port série
+//
+void Hal::reset(){
+	now = 0;
+	stop = 0;
+	model = NULL;
+	isLineStart = true;
+	memset(pinModes, 0, sizeof(pinModes));
+	memset(digitalLevels, 0, sizeof(digitalLevels));
+	memset(analogOutputs, 0, sizeof(analogOutputs));
+	for(uint8_t i = 0; i < HAL_ANALOG_PINS; i++) analogInputs[i] = 1023;
+	memset(eeprom, 0xFF, HAL_EEPROM_SIZE);
+	inputs.clear();
+	received.clear();
+}
+
+// Méthode retournant l'heure virtuelle en microsecondes
+//
+uint64_t Hal::getMicros(){
+	return now;
+}
+
+// Méthode faisant avancer l'horloge virtuelle
+// Le modèle physique est mis à jour et les lignes programmées sur le port série arrivent dès que leur heure est atteinte
+// Quand la durée de la simulation est écoulée, le programme se termine
+//	- micros: la durée en microsecondes
+//
+void Hal::advance(uint64_t micros){
+	now += micros;
+	if(model != NULL) model(now);
+	deliver();
+	if(stop > 0 && now >= stop){
+		fflush(stdout);
+		exit(0);
+	}
+}
+
+// Méthode fixant la durée de la simulation
+//	- micros: l'heure virtuelle à laquelle le programme se termine, 0 pour ne jamais s'arrêter
+//
+void Hal::stopAt(uint64_t micros){
+	stop = micros;
+}
+
+// Méthode enregistrant le modèle physique de l'environnement de la carte
+//	- model: la procédure appelée avec l'heure virtuelle à chaque avance de l'horloge, NULL pour des capteurs fixes
+//
+void Hal::setModel(Model model){
+	Hal::model = model;
+}
+
+// Méthode programmant la réception d'une ligne sur le port série
+// La fin de ligne est ajoutée comme le ferait Serial.println() côté PC
+//	- at: l'heure virtuelle de réception en microsecondes
+//	- line: le texte de la ligne
+//
+void Hal::scheduleInput(uint64_t at, const char* line){
+	ScheduledInput input;
+	input.at = at;
+	input.bytes.assign(line, line + strlen(line));
+	input.bytes.push_back('\n');
+	std::vector<ScheduledInput>::iterator position = inputs.begin();
+	while(position != inputs.end() && position->at <= at) position++;
+	inputs.insert(position, input);
+	deliver();
+}
+
+// Méthode activant l'horodatage virtuel de chaque ligne émise sur le port série
+//	- enabled: true pour préfixer les lignes par l'heure virtuelle
+//
+void Hal::setTimestamps(bool enabled){
+	isTimestamped = enabled;
+}
+
+// Méthode retournant le prochain octet reçu sur le port série, -1 si aucun
+//
+int Hal::receive(){
+	if(received.empty()) return -1;
+	uint8_t byte = received.front();
+	received.pop_front();
+	return byte;
+}
+
+// Méthode retournant le prochain octet reçu sans le retirer, -1 si aucun
+//
+int Hal::peekReceived(){
+	if(received.empty()) return -1;
+	return received.front();
+}
+
+// Méthode retournant le nombre d'octets reçus en attente de lecture
+//
+int Hal::countReceived(){
+	return received.size();
+}
+
+// Méthode émettant un octet sur le port série
+//	- byte: l'octet émis
+//
+void Hal::transmit(uint8_t byte){
+	if(isTimestamped && isLineStart) printTime(stdout);
+	fputc(byte, stdout);
+	isLineStart = byte == '\n';
+}
+
+// Méthode activant l'affichage du contenu de l'écran LCD à chaque changement
+//	- enabled: true pour afficher l'écran sur la sortie d'erreur
+//
+void Hal::setLCDTrace(bool enabled){
+	isLCDTraced = enabled;
+}
+
+// Méthode affichant le contenu de l'écran LCD sur la sortie d'erreur si l'affichage est activé
+//	- top: le texte de la ligne supérieure
+//	- bottom: le texte de la ligne inférieure
+//
+void Hal::traceLCD(const char* top, const char* bottom){
+	if(!isLCDTraced) return;
+	printTime(stderr);
+	fprintf(stderr, "LCD |%s|%s|\n", top, bottom);
+}
+
+// Méthode privée plaçant dans le tampon de réception les lignes programmées dont l'heure est atteinte
+//
+void Hal::deliver(){
+	while(!inputs.empty() && inputs.front().at <= now){
+		received.insert(received.end(), inputs.front().bytes.begin(), inputs.front().bytes.end());
+		inputs.erase(inputs.begin());
+	}
+}
+
+// Méthode privée écrivant l'heure virtuelle au format [secondes.millisecondes]
+//	- file: le flux de sortie
+//
+void Hal::printTime(FILE* file){
+	fprintf(file, "[%llu.%03llu] ", (unsigned long long)(now / 1000000), (unsigned long long)(now / 1000 % 1000));
+}
@@ -0,0 +1,80 @@
+/*
+		Hal.h - Couche d'abstraction matérielle permettant d'exécuter le firmware sur le PC (environnement native)
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+*/
+
+#ifndef Hal_h
+#define Hal_h
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Nombre de broches numériques et d'entrées analogiques d'un Arduino Nano
+#define HAL_DIGITAL_PINS 20
+#define HAL_ANALOG_PINS 8
+
+// Taille de l'EEPROM d'un ATmega328
+#define HAL_EEPROM_SIZE 1024
+
+// Durée virtuelle consommée par chaque lecture de l'horloge (millis() ou micros()), en microsecondes
+// Sans elle, une attente active sur millis() ne se terminerait jamais
+#ifndef HAL_POLL_COST
+#define HAL_POLL_COST 1
+#endif
+
+class Hal{
+
+	public:
+		typedef void (*Model)(uint64_t now);
+
+		static void reset();
+
+		// Horloge virtuelle, en microsecondes depuis le démarrage
+		static uint64_t getMicros();
+		static void advance(uint64_t micros);
+		static void stopAt(uint64_t micros);
+
+		// Modèle physique appelé à chaque avance de l'horloge, qui fait réagir l'environnement aux sorties du firmware
+		static void setModel(Model model);
+
+		// Etat des broches
+		static uint8_t pinModes[HAL_DIGITAL_PINS];
+		static uint8_t digitalLevels[HAL_DIGITAL_PINS];
+		static int analogOutputs[HAL_DIGITAL_PINS];
+		static int analogInputs[HAL_ANALOG_PINS];
+
+		// Contenu de l'EEPROM
+		static uint8_t eeprom[HAL_EEPROM_SIZE];
+
+		// Valeurs renvoyées par les capteurs simulés
+		static float airTemperature;
+		static float airHumidity;
+		static bool isAirConnected;
+		static float waterTemperature;
+		static bool isWaterConnected;
+
+		// Port série: les lignes programmées sont reçues à leur heure, les octets émis sont écrits sur la sortie standard
+		static void scheduleInput(uint64_t at, const char* line);
+		static void setTimestamps(bool enabled);
+		static int receive();
+		static int peekReceived();
+		static int countReceived();
+		static void transmit(uint8_t byte);
+
+		// Affichage du contenu de l'écran LCD sur la sortie d'erreur à chaque changement
+		static void setLCDTrace(bool enabled);
+		static void traceLCD(const char* top, const char* bottom);
+
+	private:
+		static uint64_t now;
+		static uint64_t stop;
+		static Model model;
+		static bool isTimestamped;
+		static bool isLineStart;
+		static bool isLCDTraced;
+		static void deliver();
+		static void printTime(FILE* file);
+};
+
+#endif
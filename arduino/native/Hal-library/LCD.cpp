@@ -0,0 +1,142 @@
+/*
+		LCD.cpp - Implémentation de l'écran LCD M18ST05A simulé
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Le contenu des deux lignes est conservé tel qu'il apparaîtrait sur l'écran et peut être lu par getLine()
+		Chaque changement est affiché sur la sortie d'erreur quand Hal::setLCDTrace() l'a demandé
+		Aucun octet n'étant envoyé, les statistiques de la liaison série sont toujours nulles
+*/
+
+#include <LCD.h>
+
+const char LCD::SYMBOL_DEGREE = 0xb0;
+const char LCD::CLOCK_FORMAT_EU = 0x01;
+const char LCD::CLOCK_FORMAT_US = 0x02;
+const char LCD::DISPLAY_TOP = 0x21;
+const char LCD::DISPLAY_BOTTOM = 0x22;
+const char LCD::DISPLAY_BOTH = 0x20;
+
+// Constructeur de la classe LCD
+//	- rx, tx: les broches de la liaison série, sans objet pour l'écran simulé
+//
+LCD::LCD(uint8_t rx, uint8_t tx){
+	clearDisplay(DISPLAY_BOTH);
+}
+
+// Méthode de préparation du matériel, sans objet pour l'écran simulé
+//
+void LCD::begin(){}
+
+// Méthode effaçant une ligne ou les deux
+//	- line: DISPLAY_TOP, DISPLAY_BOTTOM ou DISPLAY_BOTH
+//
+void LCD::clearDisplay(char line){
+	for(uint8_t i = 0; i < LCD_LINES; i++){
+		if(line == DISPLAY_BOTH || line == (i == 0 ? DISPLAY_TOP : DISPLAY_BOTTOM)){
+			memset(glass[i], ' ', LCD_COLUMNS);
+			glass[i][LCD_COLUMNS] = '\0';
+		}
+	}
+	textLine = line == DISPLAY_BOTTOM ? 1 : 0;
+	textColumn = 0;
+	isClockShown = false;
+}
+
+// Méthode effaçant une ligne et y affichant un texte à partir de la colonne donnée
+//
+void LCD::displayAt(const char* text, char line, int column){
+	clearDisplay(line);
+	if(column < LCD_COLUMNS){
+		textColumn = column;
+		displayAfter(text);
+	}
+	else trace();
+}
+
+// Méthode effaçant une ligne et y affichant un texte centré
+//
+void LCD::displayCenter(const char* text, char line){
+	int length = strlen(text);
+	displayAt(text, line, length < LCD_COLUMNS ? (LCD_COLUMNS - length) / 2 : 0);
+}
+
+// Méthode affichant un texte à la suite du précédent, les caractères au-delà de la dernière colonne sont perdus
+//
+void LCD::displayAfter(const char* text){
+	while(*text && textColumn < LCD_COLUMNS) glass[textLine][textColumn++] = *text++;
+	trace();
+}
+
+// Méthodes affichant un texte déclaré avec F("..."), qui reste une chaîne ordinaire dans l'exécution native
+//
+void LCD::displayAt(const __FlashStringHelper* text, char line, int column){
+	displayAt((PGM_P)text, line, column);
+}
+
+void LCD::displayCenter(const __FlashStringHelper* text, char line){
+	displayCenter((PGM_P)text, line);
+}
+
+void LCD::displayAfter(const __FlashStringHelper* text){
+	displayAfter((PGM_P)text);
+}
+
+// Méthodes de l'horloge de l'écran: son affichage remplace le texte des deux lignes
+//
+void LCD::displayClock(){
+	isClockShown = true;
+	trace();
+}
+
+void LCD::setClock(){}
+
+void LCD::clockFormat(char format){}
+
+// Méthodes de statistiques de la liaison série, sans objet pour l'écran simulé
+//
+uint8_t LCD::getQueueHighWater(){
+	return 0;
+}
+
+void LCD::resetQueueHighWater(){}
+
+// Méthode de suspension de l'envoi, sans objet pour l'écran simulé qui n'a pas de file d'attente
+//
+void LCD::hold(bool isHeld){}
+
+// Méthode indiquant qu'aucun octet n'est en cours d'envoi, toujours vrai pour l'écran simulé
+//
+bool LCD::isIdle(){
+	return true;
+}
+
+long LCD::getBytesSaved(){
+	return 0;
+}
+
+void LCD::resetBytesSaved(){}
+
+// Méthode retournant le texte affiché sur une ligne
+//	- index: 0 pour la ligne supérieure, 1 pour la ligne inférieure
+//
+const char* LCD::getLine(uint8_t index){
+	return glass[index % LCD_LINES];
+}
+
+// Méthode retournant true si l'écran affiche son horloge
+//
+bool LCD::isClockDisplayed(){
+	return isClockShown;
+}
+
+// Méthode privée affichant le contenu de l'écran sur la sortie d'erreur
+//
+void LCD::trace(){
+	if(isClockShown){
+		char clock[LCD_COLUMNS + 1];
+		snprintf(clock, sizeof(clock), "%02d:%02d:%02d        ", hour(), minute(), second());
+		Hal::traceLCD(clock, "                ");
+	}
+	else Hal::traceLCD(glass[0], glass[1]);
+}
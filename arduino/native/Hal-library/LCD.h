@@ -0,0 +1,66 @@
+/*
+		LCD.h - Ecran LCD M18ST05A simulé pour l'environnement native
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Même interface que la librairie M18ST05A-lcd-library utilisée sur la carte
+*/
+
+#ifndef LCD_h
+#define LCD_h
+
+#include <Arduino.h>
+#include <Time.h>
+
+// Dimensions de l'écran M18ST05A
+#define LCD_LINES 2
+#define LCD_COLUMNS 16
+
+// Vitesse de la liaison série de l'écran M18ST05A
+#define LCD_SPEED 9600
+
+// Cadencement du Timer1 par la liaison de l'écran, repris pour le calcul du rapport cyclique des LEDs
+#define LCD_TIMER_PRESCALER 8
+#define LCD_TIMER_TOP(speed) (F_CPU / LCD_TIMER_PRESCALER / (speed) - 1)
+
+class LCD{
+
+	public:
+		static const char SYMBOL_DEGREE;
+		static const char CLOCK_FORMAT_EU;
+		static const char CLOCK_FORMAT_US;
+		static const char DISPLAY_TOP;
+		static const char DISPLAY_BOTTOM;
+		static const char DISPLAY_BOTH;
+
+		LCD(uint8_t rx, uint8_t tx);
+
+		void begin();
+		void clearDisplay(char lines);
+		void displayAt(const char* text, char line, int column);
+		void displayCenter(const char* text, char line);
+		void displayAfter(const char* text);
+		void displayAt(const __FlashStringHelper* text, char line, int column);
+		void displayCenter(const __FlashStringHelper* text, char line);
+		void displayAfter(const __FlashStringHelper* text);
+		void displayClock();
+		void setClock();
+		void clockFormat(char format);
+		uint8_t getQueueHighWater();
+		void resetQueueHighWater();
+		void hold(bool isHeld);
+		bool isIdle();
+		long getBytesSaved();
+		void resetBytesSaved();
+		const char* getLine(uint8_t index);
+		bool isClockDisplayed();
+
+	private:
+		char glass[LCD_LINES][LCD_COLUMNS + 1];
+		int8_t textLine;
+		uint8_t textColumn;
+		bool isClockShown;
+		void trace();
+};
+
+#endif
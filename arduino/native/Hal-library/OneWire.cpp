@@ -0,0 +1,57 @@
+/*
+		OneWire.cpp - Implémentation du bus 1-Wire simulé
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Les CRC sont calculés comme dans la version portable de la librairie OneWire,
+		ils donnent donc les mêmes valeurs que _crc_ibutton_update() et _crc16_update() sur la carte
+*/
+
+#include <OneWire.h>
+
+// Constructeur de la classe OneWire
+//	- pin: la broche du bus
+//
+OneWire::OneWire(uint8_t pin){
+	this->pin = pin;
+}
+
+// Méthode calculant le CRC8 Dallas d'une suite d'octets
+//
+uint8_t OneWire::crc8(const uint8_t* addr, uint8_t len){
+	uint8_t crc = 0;
+	while(len--){
+		uint8_t inbyte = *addr++;
+		for(uint8_t i = 8; i; i--){
+			uint8_t mix = (crc ^ inbyte) & 0x01;
+			crc >>= 1;
+			if(mix) crc ^= 0x8C;
+			inbyte >>= 1;
+		}
+	}
+	return crc;
+}
+
+// Méthode vérifiant le CRC16 inversé reçu avec une suite d'octets
+//
+bool OneWire::check_crc16(const uint8_t* input, uint16_t len, const uint8_t* inverted_crc, uint16_t crc){
+	crc = ~crc16(input, len, crc);
+	return (crc & 0xFF) == inverted_crc[0] && (crc >> 8) == inverted_crc[1];
+}
+
+// Méthode calculant le CRC16 (polynôme 0xA001) d'une suite d'octets
+//
+uint16_t OneWire::crc16(const uint8_t* input, uint16_t len, uint16_t crc){
+	static const uint8_t oddparity[16] = {0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0};
+	for(uint16_t i = 0; i < len; i++){
+		uint16_t cdata = input[i];
+		cdata = (cdata ^ crc) & 0xff;
+		crc >>= 8;
+		if(oddparity[cdata & 0x0F] ^ oddparity[cdata >> 4]) crc ^= 0xC001;
+		cdata <<= 6;
+		crc ^= cdata;
+		cdata <<= 1;
+		crc ^= cdata;
+	}
+	return crc;
+}
@@ -0,0 +1,27 @@
+/*
+		OneWire.h - Bus 1-Wire simulé pour l'environnement native
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Seuls le constructeur et les calculs de CRC sont fournis: la sonde DS18B20 est simulée au niveau de DallasTemperature
+*/
+
+#ifndef OneWire_h
+#define OneWire_h
+
+#include <Arduino.h>
+
+class OneWire{
+
+	public:
+		OneWire(uint8_t pin);
+
+		static uint8_t crc8(const uint8_t* addr, uint8_t len);
+		static bool check_crc16(const uint8_t* input, uint16_t len, const uint8_t* inverted_crc, uint16_t crc = 0);
+		static uint16_t crc16(const uint8_t* input, uint16_t len, uint16_t crc = 0);
+
+	private:
+		uint8_t pin;
+};
+
+#endif
@@ -0,0 +1,149 @@
+/*
+		main.cpp - Programme principal de l'environnement native
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+
+		Exécute setup() puis loop() sur l'horloge virtuelle de la couche Hal, en avançant le temps d'un pas après chaque itération
+		Utilisation: program [-d durée] [-s pas] [-i script] [-e eeprom] [-t] [-l] [-g] [-P nom=valeur]
+			-d durée: durée simulée en secondes (86400 par défaut)
+			-s pas: temps virtuel ajouté après chaque itération de loop(), en millisecondes (10 par défaut)
+			-i script: fichier de lignes "<seconde> <texte>" reçues sur le port série à l'heure virtuelle donnée
+			-e eeprom: fichier contenant l'EEPROM, lu au démarrage et réécrit à la fin de la simulation
+			-t: préfixe chaque ligne émise sur le port série par l'heure virtuelle
+			-l: affiche le contenu de l'écran LCD sur la sortie d'erreur à chaque changement
+			-g: fait réagir les capteurs aux sorties du firmware avec le modèle thermique de l'unité (Greenhouse)
+			    et écrit en fin de simulation les mesures de la qualité de la régulation (lignes SIM:)
+			-P nom=valeur: modifie un paramètre du modèle thermique, par exemple -P heaterPower=100
+*/
+
+#include <unistd.h>
+#include <Arduino.h>
+#include <Greenhouse.h>
+
+void setup();
+void loop();
+
+// Consignes appliquées par le firmware, sur lesquelles est mesurée la qualité de la régulation
+extern int16_t airLow;
+extern int16_t airHigh;
+extern int16_t waterLow;
+extern int16_t waterHigh;
+
+static const char* eepromFile = NULL;
+static Greenhouse greenhouse;
+
+// Procédure qui charge les lignes programmées d'un script dans le port série simulé
+//	- name: le nom du fichier
+//
+static void loadScript(const char* name){
+	FILE* file = fopen(name, "r");
+	if(file == NULL){
+		perror(name);
+		exit(1);
+	}
+	char line[512];
+	while(fgets(line, sizeof(line), file) != NULL){
+		line[strcspn(line, "\r\n")] = '\0';
+		char* text;
+		double seconds = strtod(line, &text);
+		if(text == line || *line == '#') continue;
+		while(*text == ' ') text++;
+		Hal::scheduleInput((uint64_t)(seconds * 1000000), text);
+	}
+	fclose(file);
+}
+
+// Procédure qui charge le contenu de l'EEPROM depuis un fichier, s'il existe
+//
+static void loadEEPROM(){
+	FILE* file = fopen(eepromFile, "rb");
+	if(file == NULL) return;
+	fread(Hal::eeprom, 1, HAL_EEPROM_SIZE, file);
+	fclose(file);
+}
+
+// Procédure appelée à la fin de la simulation qui sauvegarde le contenu de l'EEPROM
+//
+static void saveEEPROM(){
+	fflush(stdout);
+	FILE* file = fopen(eepromFile, "wb");
+	if(file == NULL) return;
+	fwrite(Hal::eeprom, 1, HAL_EEPROM_SIZE, file);
+	fclose(file);
+}
+
+// Procédure appelée à chaque avance de l'horloge virtuelle quand le modèle thermique est activé
+//
+static void updateGreenhouse(uint64_t now){
+	greenhouse.update(now);
+}
+
+// Procédure appelée à la fin de la simulation qui écrit les mesures de la qualité de la régulation
+//
+static void reportGreenhouse(){
+	fflush(stdout);
+	greenhouse.report(stdout);
+}
+
+// Procédure qui modifie un paramètre du modèle thermique donné sous la forme nom=valeur
+//
+static void setGreenhouseParameter(char* assignment){
+	char* value = strchr(assignment, '=');
+	if(value != NULL) *value++ = '\0';
+	if(value == NULL || !greenhouse.setParameter(assignment, atof(value))){
+		fprintf(stderr, "Paramètre inconnu: %s\n", assignment);
+		exit(1);
+	}
+}
+
+int main(int argc, char** argv){
+	double duration = 86400;
+	double step = 10;
+	int option;
+	Hal::reset();
+	while((option = getopt(argc, argv, "d:s:i:e:tlgP:")) != -1){
+		switch(option){
+			case 'd':
+				duration = atof(optarg);
+				break;
+			case 's':
+				step = atof(optarg);
+				break;
+			case 'i':
+				loadScript(optarg);
+				break;
+			case 'e':
+				eepromFile = optarg;
+				break;
+			case 't':
+				Hal::setTimestamps(true);
+				break;
+			case 'l':
+				Hal::setLCDTrace(true);
+				break;
+			case 'g':
+				Hal::setModel(updateGreenhouse);
+				atexit(reportGreenhouse);
+				break;
+			case 'P':
+				setGreenhouseParameter(optarg);
+				break;
+			default:
+				fprintf(stderr, "Utilisation: %s [-d durée] [-s pas] [-i script] [-e eeprom] [-t] [-l] [-g] [-P nom=valeur]\n", argv[0]);
+				return 1;
+		}
+	}
+	if(eepromFile != NULL){
+		loadEEPROM();
+		atexit(saveEEPROM);
+	}
+	greenhouse.watchBands(&airLow, &airHigh, &waterLow, &waterHigh);
+
+	// La simulation se termine dans Hal::advance() dès que la durée est écoulée, même au milieu de setup()
+	Hal::stopAt((uint64_t)(duration * 1000000));
+	setup();
+	while(true){
+		loop();
+		Hal::advance((uint64_t)(step * 1000));
+	}
+}
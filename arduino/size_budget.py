@@ -0,0 +1,83 @@
+# -*- coding: utf-8 -*-
+
+# Script PlatformIO exécuté après l'édition de liens du firmware (voir extra_scripts dans platformio.ini)
+# Il affiche l'occupation de la mémoire flash et de la SRAM, section par section, ainsi que les plus gros symboles
+# de chaque section, puis fait échouer la compilation si l'un des budgets est dépassé
+# La SRAM de l'ATmega328 ne fait que 2048 octets: ce qui n'est pas occupé par .data et .bss reste pour la pile
+
+import subprocess
+
+Import('env')
+
+# Liste des constantes
+#
+# Budget de SRAM occupée de façon statique (.data + .bss), le reste de la SRAM est laissé à la pile
+RAM_BUDGET = 1536
+
+# Budget de mémoire flash (.text + .data), le bootloader occupe les 2 derniers Ko sur les 32 Ko disponibles
+FLASH_BUDGET = 30720
+
+# Nombre de symboles affichés pour chaque section
+TOP_SYMBOLS = 10
+
+# Correspondance entre le type de symbole rapporté par nm et la section qui le contient
+SYMBOL_SECTIONS = {'t': '.text', 'w': '.text', 'd': '.data', 'b': '.bss'}
+
+# Fonction qui exécute un outil de la chaîne de compilation et retourne sa sortie sous forme de lignes
+#
+def runTool(command):
+	output = subprocess.check_output(command)
+	if not isinstance(output, str):
+		output = output.decode('utf-8', 'replace')
+	return output.splitlines()
+
+# Fonction qui retourne la taille de chaque section du firmware, lue dans la sortie de size -A
+#
+def getSections(sizeTool, firmware):
+	sections = {}
+	for line in runTool([sizeTool, '-A', firmware]):
+		fields = line.split()
+		if len(fields) == 3 and fields[0].startswith('.') and fields[1].isdigit():
+			sections[fields[0]] = int(fields[1])
+	return sections
+
+# Fonction qui retourne les symboles du firmware classés par section, du plus gros au plus petit
+#
+def getSymbols(nmTool, firmware):
+	symbols = {'.text': [], '.data': [], '.bss': []}
+	for line in runTool([nmTool, '--size-sort', '-S', '-C', '-r', firmware]):
+		fields = line.split(None, 3)
+		if len(fields) < 4:
+			continue
+		section = SYMBOL_SECTIONS.get(fields[2].lower())
+		if section is not None:
+			symbols[section].append((int(fields[1], 16), fields[3]))
+	return symbols
+
+# Procédure appelée par PlatformIO une fois le fichier .elf produit
+# Elle retourne 1 pour faire échouer la compilation si un budget est dépassé
+#
+def checkBudget(source, target, env):
+	firmware = str(target[0])
+	sizeTool = env.subst('$SIZETOOL')
+	nmTool = sizeTool.replace('size', 'nm')
+
+	# Les plus gros symboles de chaque section
+	symbols = getSymbols(nmTool, firmware)
+	for section in ['.text', '.data', '.bss']:
+		print('Plus gros symboles de %s:' % section)
+		for size, name in symbols[section][:TOP_SYMBOLS]:
+			print('  %6d  %s' % (size, name))
+
+	# Les totaux, comparés aux budgets
+	sections = getSections(sizeTool, firmware)
+	ram = sections.get('.data', 0) + sections.get('.bss', 0) + sections.get('.noinit', 0)
+	flash = sections.get('.text', 0) + sections.get('.data', 0)
+	print('SRAM statique: %d / %d octets (pile: %d octets)' % (ram, RAM_BUDGET, 2048 - ram))
+	print('Flash: %d / %d octets' % (flash, FLASH_BUDGET))
+	if ram > RAM_BUDGET or flash > FLASH_BUDGET:
+		print('Budget mémoire dépassé')
+		return 1
+	return 0
+
+env.AddPostAction('$BUILD_DIR/${PROGNAME}.elf', checkBudget)
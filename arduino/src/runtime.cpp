@@ -1,12 +1,35 @@
 #include <Arduino.h>
+#include <limits.h>
+#include <stddef.h>
+#include <EEPROM.h>
 #include <LCD.h>
 #include <DHT.h>
 #include <OneWire.h>
 #include <DallasTemperature.h>
-
-// Temps de repos en millisecondes entre deux itérations de la boucle principale
+#include <Scheduler.h>
+#include <SerialLine.h>
+#include <Telemetry.h>
+#include <History.h>
+#include <PID.h>
+#include <Profiler.h>
+#include <Memory.h>
+#include <Fixed.h>
+#include <Sensors.h>
+
+// Temps en millisecondes entre deux points de l'animation d'attente pendant l'initialisation
 #define LOOP_DELAY 100
 
+// Temps en millisecondes entre deux demandes du programme de germination au PC pendant l'initialisation
+#define PROGRAM_RETRY_DELAY 2000
+
+// Temps en millisecondes entre deux demandes du programme de germination au PC après un démarrage autonome
+#define PROGRAM_SYNC_DELAY 10000
+
+// Adresse et version du programme de germination conservé en EEPROM
+// La version doit changer à chaque modification de la structure StoredProgram
+#define EEPROM_PROGRAM_ADDRESS 0
+#define EEPROM_PROGRAM_VERSION 3
+
 // Une seconde en millisecondes, utilisé pour vérifier toutes les action à dérouler de seconde en seconde
 #define SECOND_DELAY 1000
 
@@ -14,7 +37,31 @@
 #define MINUTE_DELAY 60000
 
 // Un quart d'heure en millisecondes, utilisé pour vérifier toutes les action à dérouler de 15 min en 15 min
-#define QUARTER_DELAY 900000
+#define QUARTER_DELAY 900000UL
+
+// Limites en secondes de la période de mesure des sondes, qui est aussi celle de l'historique des mesures
+// En dessous de 5 secondes, les capteurs d'air et la conversion des sondes d'eau n'ont plus le temps de se terminer
+#define HISTORY_MIN_RATE 5
+#define HISTORY_MAX_RATE 900
+
+// Nombre de périodes de mesure au-delà duquel une mesure du cache des sondes est trop ancienne pour être utilisée
+// Une mesure est normalement rafraîchie à chaque période: au-delà de deux, le cycle de mesure ne se termine plus
+#define SAMPLE_MAX_PERIODS 2
+
+// Nombre de mesures en attente d'envoi à partir duquel l'historique est envoyé au PC sans attendre sa demande
+#define HISTORY_WATERMARK (HISTORY_CAPACITY / 2)
+
+// Place libre nécessaire dans le tampon d'envoi du port série pour envoyer une mesure de l'historique sans bloquer
+#define HISTORY_LINE_LENGTH 50
+
+// Place libre nécessaire dans le tampon d'envoi du port série pour envoyer une ligne des temps d'exécution sans bloquer
+// La plus longue est une ligne STATS_BINS: préfixe (11), nom (STATS_NAME_LENGTH), classe (2), 4 nombres (24) et CRLF (2)
+// Elle doit rester sous les 63 octets du tampon d'envoi, sans quoi elle ne pourrait jamais partir sans bloquer
+#define STATS_NAME_LENGTH 8
+#define STATS_BINS_PER_LINE 4
+#define STATS_LINE_LENGTH (11 + STATS_NAME_LENGTH + 2 + 6 * STATS_BINS_PER_LINE + 2)
+static_assert(STATS_LINE_LENGTH <= SERIAL_TX_BUFFER_SIZE - 1, "Une ligne STATS_BINS ne tient pas dans le tampon d'envoi");
+static_assert(PROFILER_BINS == 2 * STATS_BINS_PER_LINE, "L'histogramme doit tenir en deux lignes STATS_BINS");
 
 // Temps d'affichage d'un paramètre en millisecondes
 #define DISPLAY_TIME 2000
@@ -22,17 +69,59 @@
 // Vitesse de communication sur le port série
 #define SERIAL_SPEED 115200
 
-// Longueur maximale d'une phrase à envoyer par le port série
-#define SERIAL_MAX_LENGTH 50
-
-// Longueur maximale d'un réel à transformer en string par la fonction dtostfr
-#define FLOAT_MAX_LENGTH 10
+// Identifiants fixes des mesures envoyées en trames binaires, ils doivent correspondre à ceux de raspberry/telemetry.py
+#define MSG_FLOW 1
+#define MSG_HEAT 2
+#define MSG_LIGHT 3
+#define MSG_FAN 4
+// Les identifiants 5 à 7 ne sont plus utilisés: les mesures des sondes passent par l'historique, toujours envoyé en texte
+// L'identifiant 8 n'est plus utilisé non plus
+#define MSG_OVERRUNS 9
+#define MSG_LCD_QUEUE 10
+#define MSG_LCD_SAVED 11
+#define MSG_HEAT_DUTY 12
+#define MSG_PID_KP 13
+#define MSG_PID_KI 14
+#define MSG_PID_KD 15
+#define MSG_HEAT_WINDOW 16
+#define MSG_HEAT_MIN 17
+#define MSG_FREE_RAM 18
+#define MSG_STACK_MARGIN 19
+#define MSG_HEAP_FREE 20
+#define MSG_HEAP_LARGEST 21
+#define MSG_PROBES_DOWN 22
+#define MSG_WATER_RESOLUTION 23
+#define MSG_CONVERSION_TIME 24
+#define MSG_SERIAL_OVERFLOWS 25
 
 // Longueur maximale d'une ligne à afficher à l'écran LCD
 #define LCD_MAX_LENGTH 16
 
-// Tolérence de température en degrés
-#define TEMPERATURE_TOLERENCE 1
+// Vitesse du ventilateur en pourcentage en dessous de laquelle il ne démarre pas ou finit par caler
+#define FAN_MIN_SPEED 30
+
+// Variation maximale de la vitesse du ventilateur, en pourcentage par seconde
+#define FAN_SLEW_RATE 2
+
+// Nombre de mesures sur lesquelles est lissée la vitesse visée du ventilateur
+#define FAN_SMOOTHING 4
+
+// Limites en secondes de la fenêtre de modulation de la résistance chauffante
+// Le relais n'est commuté au plus que deux fois par fenêtre
+#define HEAT_WINDOW_MIN 10
+#define HEAT_WINDOW_MAX 1800
+
+// Résolutions extrêmes des sondes d'eau, en bits: 9 bits convertissent en 94 ms au demi-degré, 12 bits en 750 ms
+// au seizième de degré
+// La résolution perd un bit par WATER_RESOLUTION_STEP d'écart entre l'eau et sa plage de consigne: elle est
+// maximale dans la plage, où le PID a besoin de finesse, et minimale quand l'eau en est loin
+#define WATER_RESOLUTION_MIN 9
+#define WATER_RESOLUTION_MAX 12
+#define WATER_RESOLUTION_STEP FIXED(1)
+
+// Limites des consignes de température acceptées, en Q7: la plage de mesure de la sonde DS18B20
+#define TEMPERATURE_MIN FIXED(-55)
+#define TEMPERATURE_MAX FIXED(125)
 
 // Définition des valeurs de retour pour l'action des interrupteurs
 #define BUTTON_COMPARE 512
@@ -71,15 +160,107 @@
 #define ANALOG_BUTTON_RIGHT 0
 #define ANALOG_BUTTON_LEFT 1
 
+// Types de paramètre des commandes reçues du PC, utilisés par la table des commandes pour convertir le paramètre
+#define ARG_INT 0
+#define ARG_FIXED 1
+#define ARG_TIME 2
+#define ARG_STRING 3
+
+// Nombre de champs de la trame SET_PROGRAM_BLOCK et longueur du CRC16 hexadécimal qui la termine
+#define BLOCK_FIELDS 18
+#define BLOCK_CRC_LENGTH 4
+
+// Constantes de l'empreinte FNV-1a utilisée pour reconnaître les noms de commandes
+#define FNV_OFFSET 2166136261UL
+#define FNV_PRIME 16777619UL
+
+// Longueur maximale d'un nom de commande, caractère de fin de chaîne compris
+#define COMMAND_NAME_LENGTH 18
+
+// Paramètre d'une commande, converti suivant le type déclaré dans la table des commandes
+// Le type ARG_TIME (HH:MM) est converti en minutes depuis minuit dans asInt
+// Le type ARG_FIXED (nombre décimal) est converti en virgule fixe Q7 dans asInt
+typedef union{
+	long asInt;
+	const char* asString;
+} CommandArg;
+
+// Entrée de la table des commandes: empreinte du nom, nom, type du paramètre et procédure à exécuter
+typedef void (*CommandHandler)(const CommandArg* arg);
+typedef struct{
+	uint32_t hash;
+	char name[COMMAND_NAME_LENGTH];
+	uint8_t type;
+	CommandHandler handler;
+} Command;
+
+// Fonction qui calcule à la compilation l'empreinte FNV-1a d'un nom de commande
+//
+constexpr uint32_t commandHash(const char* name, uint32_t hash = FNV_OFFSET){
+	return *name == '\0' ? hash : commandHash(name + 1, (hash ^ (uint8_t)*name) * FNV_PRIME);
+}
+
+// Déclaration d'une entrée de la table des commandes
+#define COMMAND(name, type, handler) { commandHash(name), name, type, handler }
+
+// Programme de germination complet reçu en une seule trame, validé avant d'être appliqué
+// Les températures sont en virgule fixe Q7 et les gains du PID en virgule fixe avec PID_GAIN_SHIFT bits de fraction
+typedef struct{
+	char name[LCD_MAX_LENGTH];
+	unsigned long time;
+	long red;
+	long green;
+	long blue;
+	long lightOn;
+	long lightOff;
+	long flowOn;
+	long flowOff;
+	long waterLow;
+	long waterHigh;
+	long airLow;
+	long airHigh;
+	long pidKp;
+	long pidKi;
+	long pidKd;
+	long heatWindow;
+	long heatMinimum;
+} ProgramBlock;
+
+// Dernier programme de germination accepté, conservé en EEPROM pour pouvoir démarrer sans PC
+// Le CRC16 porte sur tous les champs qui le précèdent
+typedef struct{
+	uint8_t version;
+	char name[LCD_MAX_LENGTH];
+	int red;
+	int green;
+	int blue;
+	int lightOn;
+	int lightOff;
+	int flowOn;
+	int flowOff;
+	fixed_t waterLow;
+	fixed_t waterHigh;
+	fixed_t airLow;
+	fixed_t airHigh;
+	long pidKp;
+	long pidKi;
+	long pidKd;
+	int heatWindow;
+	int heatMinimum;
+	uint16_t crc;
+} StoredProgram;
+
 // Prototypes des procédures et fonctions
 //
-void getWaterTemperature();																												// Procédure qui permet de relever la température de l'eau du bassin d'hydroculture
-void getAirTemperature();																													// Procédure qui permet de relever la température de l'air dans l'unité hydroponique
-void getAirHumidity();																														// Procédure qui permet de relever l'humidité de l'air dans l'unité hydroponique
 void getProbesValues();																														// Procédure qui collecte les valeurs des sondes
-void sendProbesValues();																													// Procédure qui envoie les valeurs des sondes au PC de surveillance
+void checkProbes();																																// Procédure appelée à chaque itération qui termine la collecte des sondes une fois leur lecture terminée
+fixed_t getWorstZone(uint8_t quantity, bool lowest);															// Fonction qui retourne la mesure de la zone la plus basse ou la plus haute pour une grandeur
+void sendProbesValues();																													// Procédure qui enregistre les valeurs des sondes dans l'historique des mesures
 void provideFeedbacks();																													// Procédure qui prend les actions correctives si les valeurs sous contrôle dépassent les limites définies par le programme
 void setFan(int speed);																														// Procédure qui ajuste la vitesse du ventilateur
+void checkFan();																																	// Procédure appelée chaque seconde qui rapproche progressivement la vitesse du ventilateur de la vitesse visée
+void checkHeat();																																	// Procédure appelée chaque seconde qui pilote la résistance chauffante par fenêtres proportionnelles à la sortie du PID
+void applyHeatSettings();																													// Procédure qui règle le PID de l'eau d'après le programme et envoie ses réglages au PC
 void heatOn();																																		// Procédure qui démarre la résistance chauffante
 void heatOff();																																		// Procédure qui arrête la résistance chauffante
 void pumpOn();																																		// Procédure qui démarre la pompe d'arrosage
@@ -88,39 +269,135 @@ void setLED(int r, int g, int b);																									// Procédure qui règ
 void setInspect(bool state);																											// Procédure utilisée pour allumer la lumière verte
 void checkLED();																																	// Procédure appelée chaque seconde qui vérifie si on doit allumer ou éteindre les lumières
 void checkLCD();																																	// Procédure appelée chaque seconde qui vérifie si on doit afficher les paramètres de l'unité sur l'écran LCD et les fait défiler
+void displayMeasure(uint8_t zone, uint8_t quantity);															// Procédure qui affiche sur l'écran LCD la mesure d'une grandeur dans une zone
+char* formatMeasure(char* buffer, fixed_t value);																	// Fonction qui écrit une mesure en virgule fixe pour l'écran LCD
 void checkPump();																																	// Procédure appelée chaque seconde qui vérifie si on doit allumer ou éteindre la pompe d'arrosage
 int getKeys();																																		// Fonction qui retourne la valeur correspondante aux touches enfoncées
 int analogLevel(int percentage);																									// Fonction qui ajuste un pourcentage (0..100) vers une valeur analogWrite (0..255)
+int timerLevel(int percentage);																										// Fonction qui ajuste un pourcentage (0..100) vers une valeur analogWrite pour les sorties du Timer1
 void readSerial();																																// Procédure appelée à chaque itération qui scrute le port USB
-void sendUSBValue(const char* parameter, int value);															// Procédure qui envoie un nombre entier sur le port USB
-void sendUSBValue(const char* parameter, float value, int width, int precision);	// Procédure qui envoie un nombre réel sur le port USB
-void keepEventCounters();																													// Procédure qui dans la boucle principale vérifie si il est nécessaire d'activer un déclencheur
+int parseMinutes(const char* text);																								// Fonction qui convertit une heure au format HH:MM en minutes depuis minuit
+uint32_t tokenHash(const SerialLine::Token* token);																// Fonction qui calcule l'empreinte FNV-1a d'une commande reçue
+void runCommand(const SerialLine::Token* command, const SerialLine::Token* param);	// Procédure qui exécute une commande reçue à partir de la table des commandes
+void setProgram(const CommandArg* arg);																						// Commande qui règle le nom du programme
+void setClock(const CommandArg* arg);																							// Commande qui règle la date et l'heure
+void setRedLevel(const CommandArg* arg);																					// Commande qui règle le niveau de rouge
+void setGreenLevel(const CommandArg* arg);																				// Commande qui règle le niveau de vert
+void setBlueLevel(const CommandArg* arg);																					// Commande qui règle le niveau de bleu
+void setLightOn(const CommandArg* arg);																						// Commande qui règle l'heure d'allumage
+void setLightOff(const CommandArg* arg);																					// Commande qui règle l'heure d'extinction
+void setFlowOn(const CommandArg* arg);																						// Commande qui règle la durée d'arrosage
+void setFlowOff(const CommandArg* arg);																						// Commande qui règle la durée de repos de la pompe
+void setWaterLow(const CommandArg* arg);																					// Commande qui règle la température basse de l'eau
+void setWaterHigh(const CommandArg* arg);																					// Commande qui règle la température haute de l'eau
+void setAirLow(const CommandArg* arg);																						// Commande qui règle la température basse de l'air
+void setAirHigh(const CommandArg* arg);																						// Commande qui règle la température haute de l'air
+void setProgramBlock(const CommandArg* arg);																			// Commande qui charge et applique en une fois le programme complet
+bool parseProgramBlock(const char* text, ProgramBlock* block);										// Fonction qui vérifie le CRC et découpe la trame du programme complet
+bool parseBlockLong(const char** cursor, long low, long high, long* value);				// Fonction qui lit un entier borné dans la trame du programme complet
+bool parseBlockFixed(const char** cursor, uint8_t shift, long low, long high, long* value);	// Fonction qui lit un nombre décimal en virgule fixe dans la trame du programme complet
+bool parseBlockTime(const char** cursor, long* value);														// Fonction qui lit une heure HH:MM dans la trame du programme complet
+void listenSerial(unsigned long duration);																				// Procédure qui scrute le port USB pendant la durée donnée au lieu d'attendre
+void saveProgram();																																// Procédure qui conserve le programme de germination en EEPROM
+bool restoreProgram();																														// Fonction qui restaure le programme de germination conservé en EEPROM
+void requestProgram();																														// Procédure appelée régulièrement qui redemande le programme au PC après un démarrage autonome
+void sendUSBState(uint8_t id, const __FlashStringHelper* parameter, bool state);	// Procédure qui envoie un état ON/OFF sur le port USB
+void sendUSBValue(uint8_t id, const __FlashStringHelper* parameter, int value);		// Procédure qui envoie un nombre entier sur le port USB
+void sendUSBValue(uint8_t id, const __FlashStringHelper* parameter, long value, uint8_t shift, uint8_t precision);	// Procédure qui envoie un nombre en virgule fixe sur le port USB
+void setTelemetry(const CommandArg* arg);																					// Commande qui choisit le protocole texte ou binaire pour les mesures
+void adaptWaterResolution();																											// Procédure qui adapte la résolution des sondes d'eau à l'écart entre l'eau et sa plage de consigne
+void startProbesCycle();																													// Procédure appelée chaque minute qui lance le cycle de mesure, de correction et d'envoi des sondes
+void sendSchedulerStats();																												// Procédure appelée chaque quart d'heure qui envoie les dépassements d'échéances, l'état de l'écran LCD et les lignes tronquées au PC
+void sendMemoryStats();																														// Procédure appelée chaque quart d'heure qui envoie l'état de la mémoire SRAM au PC
+void flushHistory();																															// Procédure appelée à chaque itération qui envoie l'historique des mesures sans bloquer
+void getHistory(const CommandArg* arg);																						// Commande qui demande l'envoi de l'historique à partir d'une séquence
+void setHistoryRate(const CommandArg* arg);																				// Commande qui règle la période de mesure des sondes et de l'historique
+void startScheduler();																														// Procédure qui enregistre les tâches périodiques auprès de l'ordonnanceur
+void startProfiler();																															// Procédure qui enregistre les sondes du profileur mesurant les étapes de la boucle principale
+void getStats(const CommandArg* arg);																							// Commande qui demande l'envoi des temps d'exécution mesurés par le profileur
+void flushStats();																																// Procédure appelée à chaque itération qui envoie les temps d'exécution sans bloquer
 
 // Initialisation de l'écran LCD
 LCD lcd(LCD_RX_PIN, LCD_TX_PIN);
 
-// On initialise le capteur de température et humidité
+// On initialise le lecteur des capteurs de température et humidité de l'air
+// Il est partagé par tous les capteurs DHT du registre, qui le redirige vers la broche de chacun
 DHT dht(DHT_PIN, DHT_TYPE);
 
-// On initialise le capteur de température de l'eau
+// On initialise le bus 1-Wire des sondes de température de l'eau
 OneWire ds18(DS18_PIN);
 DallasTemperature waterSensor(&ds18);
 
+// Registre des sondes de l'unité: type, broche du capteur DHT ou rang de la sonde DS18B20 sur le bus, et zone
+// Ajouter une sonde ou une zone revient à ajouter une ligne à cette table
+// L'identifiant d'une sonde, utilisé dans le masque des sondes en panne envoyé au PC, est son rang dans la table
+Sensors::Probe probes[] = {
+	SENSOR(SENSOR_DS18B20, 0, 0),
+	SENSOR(DHT_TYPE, DHT_PIN, 0)
+};
+#define PROBE_COUNT (sizeof(probes) / sizeof(Sensors::Probe))
+Sensors sensors(&waterSensor, &dht, probes, PROBE_COUNT);
+
+// Masque des sondes en panne envoyé en dernier au PC, le bit i correspondant à la sonde i du registre
+uint16_t probesDown = 0;
+
+// Résolution des sondes d'eau envoyée en dernier au PC, en bits; au démarrage, aucune n'a été envoyée
+uint8_t waterResolution = 0;
+
 // On démarre le programme, on est donc dans la phase d'initialisation
 bool initPhase = true;
 
 // Au démarrage, la date de l'unité de germination n'est pas défini
 bool isTimeSet = false;
 
+// Au démarrage, le programme n'a pas encore été confirmé par le PC, même s'il a été restauré de l'EEPROM
+bool isProgramSynced = false;
+
+// Au démarrage, aucun cycle de mesure n'attend ses corrections
+bool isFeedbackPending = false;
+
 // Etat des actions dans l'unité
+// fanSpeed est la vitesse appliquée au ventilateur, fanTarget celle vers laquelle elle évolue
 int fanSpeed = 100;
+int fanTarget = 0;
+fixed_t fanDemand = 0;
 bool isHeatOn = true;
 bool isPumpOn = true;
 
-// Définition des compteurs d'évènements avec action immédiate au démarrage
-int secondDelay = SECOND_DELAY;
-long minuteDelay = MINUTE_DELAY;
-long quarterDelay = QUARTER_DELAY;
+// Assemblage des lignes reçues sur le port USB, dans un tampon de taille fixe
+SerialLine serialLine(&Serial);
+
+// Envoi des mesures en trames binaires, utilisé à la place du protocole texte si le PC l'a demandé
+// Au démarrage, on utilise toujours le protocole texte
+Telemetry telemetry(&Serial);
+bool isBinaryTelemetry = false;
+
+// Ordonnanceur des tâches périodiques, basé sur des échéances absolues pour ne jamais dériver
+// On garde l'identifiant de la tâche de mesure des sondes pour pouvoir changer sa période
+Scheduler scheduler;
+int8_t probesTask;
+
+// Age maximal en millisecondes des mesures lues dans le registre des sondes par l'écran, l'historique et la régulation
+// Il suit la période de mesure, fixée par défaut à une minute
+unsigned long sampleMaxAge = SAMPLE_MAX_PERIODS * MINUTE_DELAY;
+
+// Profileur mesurant en microsecondes la durée des étapes de la boucle principale et des tâches périodiques
+// On garde l'identifiant des sondes placées dans la boucle; celles des tâches sont gérées par l'ordonnanceur
+// Un envoi des temps d'exécution est en cours tant que statsLine est positif, il les remet à zéro si isStatsReset est vrai
+Profiler profiler;
+int8_t loopProbe;
+int8_t keysProbe;
+int8_t collectProbe;
+int8_t feedbackProbe;
+int8_t recordProbe;
+int8_t serialProbe;
+int statsLine = -1;
+bool isStatsReset = false;
+
+// Historique des mesures des sondes, envoyé au PC par lots
+// Au démarrage, aucun envoi n'est en cours
+History history;
+bool isHistoryFlushing = false;
 
 // Définition du compteur d'affichage des paramètres sur l'écran LCD
 // Au démarrage, on n'affiche pas les paramètres
@@ -142,15 +419,56 @@ int lightOff = -9999;
 int flowCounter;
 int flowOn = -9999;
 int flowOff = -9999;
-float waterLow = -9999;
-float waterHigh = -9999;
-float waterTemperature;
+fixed_t waterLow = FIXED_INVALID;
+fixed_t waterHigh = FIXED_INVALID;
+
+// On prépare les variables de la régulation PID de la température de l'eau
+// La résistance chauffe heatOnTime secondes au début ou à la fin de chaque fenêtre de heatWindow secondes
+PID waterPID;
+long pidKp = 0;
+long pidKi = 0;
+long pidKd = 0;
+int heatWindow = HEAT_WINDOW_MIN;
+int heatMinimum = 0;
+int heatSecond = 0;
+int heatOnTime = 0;
+bool isHeatAtEnd = false;
 
 // On prépare les variables pour la régulation de l'air
-float airLow = -9999;
-float airHigh = -9999;
-float airTemperature;
-float airHumidity;
+// Comme celles de l'eau, les consignes sont en virgule fixe Q7, FIXED_INVALID tant qu'elles sont inconnues
+fixed_t airLow = FIXED_INVALID;
+fixed_t airHigh = FIXED_INVALID;
+
+// Table des commandes acceptées sur le port USB, stockée en mémoire flash
+// Les entrées sont rangées par empreinte croissante pour être trouvées par dichotomie (empreinte en commentaire)
+// Ajouter une commande revient à insérer une entrée à sa place dans cette table (et la procédure qui la traite)
+constexpr Command commands[] PROGMEM = {
+	COMMAND("SET_TELEMETRY", ARG_STRING, setTelemetry),						// 0CF371F3
+	COMMAND("SET_AIR_HIGH", ARG_FIXED, setAirHigh),								// 233FDD55
+	COMMAND("SET_GREEN_LEVEL", ARG_INT, setGreenLevel),						// 2734A006
+	COMMAND("SET_WATER_LOW", ARG_FIXED, setWaterLow),							// 2FE846D6
+	COMMAND("SET_PROGRAM", ARG_STRING, setProgram),								// 44E7AB60
+	COMMAND("SET_BLUE_LEVEL", ARG_INT, setBlueLevel),							// 6055E5FD
+	COMMAND("SET_LIGHT_OFF", ARG_TIME, setLightOff),							// 6E76B70A
+	COMMAND("SET_FLOW_ON", ARG_INT, setFlowOn),										// 826D0F14
+	COMMAND("SET_RED_LEVEL", ARG_INT, setRedLevel),								// 8742B0AA
+	COMMAND("GET_HISTORY", ARG_STRING, getHistory),								// 965B3F80
+	COMMAND("SET_PROGRAM_BLOCK", ARG_STRING, setProgramBlock),		// A2706BCA
+	COMMAND("STATS", ARG_STRING, getStats),												// D29A598C
+	COMMAND("SET_WATER_HIGH", ARG_FIXED, setWaterHigh),						// D40DF038
+	COMMAND("SET_AIR_LOW", ARG_FIXED, setAirLow),									// E296D9F9
+	COMMAND("SET_HISTORY_RATE", ARG_INT, setHistoryRate),					// EC0086A3
+	COMMAND("SET_TIME", ARG_INT, setClock),												// ED8A2555
+	COMMAND("SET_FLOW_OFF", ARG_INT, setFlowOff),									// F39A814E
+	COMMAND("SET_LIGHT_ON", ARG_TIME, setLightOn)									// FE976EB0
+};
+#define COMMAND_COUNT (sizeof(commands) / sizeof(Command))
+
+// Vérification à la compilation que les empreintes sont strictement croissantes, donc aussi toutes différentes
+constexpr bool hashesSorted(uint8_t i = 1){
+	return i >= COMMAND_COUNT || (commands[i - 1].hash < commands[i].hash && hashesSorted(i + 1));
+}
+static_assert(hashesSorted(), "La table des commandes doit être rangée par empreinte strictement croissante");
 
 // Initialisation
 //
@@ -159,8 +477,21 @@ void setup(){
 	// Prépare la communication vers le Raspberry Pi via le bus USB
 	Serial.begin(SERIAL_SPEED);
 
-	// Démarre la lecture de la sonde de température de l'eau
+	// Prépare l'écran LCD et le Timer1 qui cadence sa liaison série
+	// Ce réglage doit suivre init() du noyau Arduino, qui reconfigure le Timer1, et précéder les sorties PWM de l'éclairage
+	lcd.begin();
+
+	// Démarre le bus des sondes de température de l'eau
+	// La conversion est asynchrone, son résultat est collecté par checkProbes() sans bloquer la boucle principale
 	waterSensor.begin();
+	waterSensor.setWaitForConversion(false);
+
+	// Démarre le lecteur des capteurs de température et humidité de l'air
+	// Sa lecture est asynchrone, elle est avancée par checkProbes() à chaque itération
+	dht.begin();
+
+	// Recherche l'adresse de chaque sonde d'eau du registre sur le bus
+	sensors.begin();
 
 	// Prépare les GPIOs pour la commande de l'éclairage RGB
 	// On éteint les LEDs dans tous les cas
@@ -182,107 +513,71 @@ void setup(){
 	heatOff();
 	pumpOff();
 
-	// Au démarrage, on invite l'utilisateur à connecter le configurateur
-	int waitingLoop = LCD_MAX_LENGTH;
+	// Si un programme a été conservé en EEPROM, on le restaure et on démarre immédiatement
+	// Le PC sera consulté en tâche de fond pour confirmer ou remplacer ce programme
+	// On n'attend pas le LCD: les paramètres de l'unité y défileront dès que les tâches périodiques auront démarré
+	if(restoreProgram()){
+		applyHeatSettings();
+		initPhase = false;
+		lcdDisplay = 0;
+	}
 
-	// On attend le chargement du programme de germination
-	// Le délai de 2 secondes est nécessaire pour afficher la ligne sur le LCD
-	delay(DISPLAY_TIME);
-	lcd.displayCenter("INITIALISATION", LCD::DISPLAY_TOP);
+	// Sinon, on attend le chargement du programme de germination depuis le PC
+	else{
 
-	// Boucle d'attente de chargement du programme de germination
-	while(initPhase){
+		// Au démarrage, on invite l'utilisateur à connecter le configurateur
+		int waitingLoop = LCD_MAX_LENGTH;
 
-		// On affiche une série de points sur la ligne du bas pour créer une animation
-		// d'attente de chargement. A chaque itération de la boucle et si le compteur
-		// n'a pas atteint la valeur maximale de l'écran LCD, on affiche un nouveau point à la fin de la ligne
-		if(waitingLoop < LCD_MAX_LENGTH){
-			waitingLoop++;
-			delay(LOOP_DELAY);
-			lcd.displayAfter(".");
-		}
+		// On attend le chargement du programme de germination
+		// Le délai de 2 secondes est nécessaire pour afficher la ligne sur le LCD
+		delay(DISPLAY_TIME);
+		lcd.displayCenter(F("INITIALISATION"), LCD::DISPLAY_TOP);
 
-		// On a rempli la ligne. On affiche à nouveau l'invitation à l'utilisateur de
-		// connecter le configurateur avant de recommencer une série de 16 points
-		else{
-			waitingLoop = 0;
-			lcd.displayCenter("CONNECTER PC", LCD::DISPLAY_BOTTOM);
-			delay(DISPLAY_TIME);
-			lcd.displayAt(".", LCD::DISPLAY_BOTTOM, 0);
-		}
+		// Boucle d'attente de chargement du programme de germination
+		// Le programme complet est demandé en une seule trame, la demande n'est répétée que toutes les PROGRAM_RETRY_DELAY ms
+		// Pendant les pauses de l'animation, on continue de vider le port USB pour ne pas perdre une partie de la trame
+		unsigned long lastRequest = millis() - PROGRAM_RETRY_DELAY;
+		while(initPhase){
 
-		// On envoie une invitation de téléchargement sur le port USB
-		Serial.println("INIT:GET_PROGRAM");
-		readSerial();
-	}
+			// On envoie une invitation de téléchargement sur le port USB
+			if(millis() - lastRequest >= PROGRAM_RETRY_DELAY){
+				Serial.println(F("INIT:GET_PROGRAM_BLOCK"));
+				lastRequest = millis();
+			}
 
-	// On est connecté au PC configurateur, on enclenche le téléchargement du programme
-	while(!isTimeSet){
-		Serial.println("INIT:GET_TIME");
-		delay(LOOP_DELAY);
-		readSerial();
-	}
-	while(redOn == -9999){
-		Serial.println("INIT:GET_RED_LEVEL");
-		delay(LOOP_DELAY);
-		readSerial();
-	}
-	while(greenOn == -9999){
-		Serial.println("INIT:GET_GREEN_LEVEL");
-		delay(LOOP_DELAY);
-		readSerial();
-	}
-	while(blueOn == -9999){
-		Serial.println("INIT:GET_BLUE_LEVEL");
-		delay(LOOP_DELAY);
-		readSerial();
-	}
-	while(lightOn == -9999){
-		Serial.println("INIT:GET_LIGHT_ON");
-		delay(LOOP_DELAY);
-		readSerial();
-	}
-	while(lightOff == -9999){
-		Serial.println("INIT:GET_LIGHT_OFF");
-		delay(LOOP_DELAY);
-		readSerial();
-	}
-	while(flowOn == -9999){
-		Serial.println("INIT:GET_FLOW_ON");
-		delay(LOOP_DELAY);
-		readSerial();
-	}
-	while(flowOff == -9999){
-		Serial.println("INIT:GET_FLOW_OFF");
-		delay(LOOP_DELAY);
-		readSerial();
-	}
-	while(waterLow == -9999){
-		Serial.println("INIT:GET_WATER_LOW");
-		delay(LOOP_DELAY);
-		readSerial();
-	}
-	while(waterHigh == -9999){
-		Serial.println("INIT:GET_WATER_HIGH");
-		delay(LOOP_DELAY);
-		readSerial();
-	}
-	while(airLow == -9999){
-		Serial.println("INIT:GET_AIR_LOW");
-		delay(LOOP_DELAY);
-		readSerial();
-	}
-	while(airHigh == -9999){
-		Serial.println("INIT:GET_AIR_HIGH");
-		delay(LOOP_DELAY);
-		readSerial();
+			// On affiche une série de points sur la ligne du bas pour créer une animation
+			// d'attente de chargement. A chaque itération de la boucle et si le compteur
+			// n'a pas atteint la valeur maximale de l'écran LCD, on affiche un nouveau point à la fin de la ligne
+			if(waitingLoop < LCD_MAX_LENGTH){
+				waitingLoop++;
+				listenSerial(LOOP_DELAY);
+				if(initPhase) lcd.displayAfter(F("."));
+			}
+
+			// On a rempli la ligne. On affiche à nouveau l'invitation à l'utilisateur de
+			// connecter le configurateur avant de recommencer une série de 16 points
+			else{
+				waitingLoop = 0;
+				lcd.displayCenter(F("CONNECTER PC"), LCD::DISPLAY_BOTTOM);
+				listenSerial(DISPLAY_TIME);
+				if(initPhase) lcd.displayAt(F("."), LCD::DISPLAY_BOTTOM, 0);
+			}
+		}
 	}
 
 	// Au démarrage, on allume la pompe
 	flowCounter = -1;
 
-	// Finallement, on affiche l'horloge
-	lcd.setClock();
+	// Finallement, on affiche l'horloge si l'heure est connue
+	if(isTimeSet) lcd.setClock();
+
+	// Et on démarre les tâches périodiques
+	startProfiler();
+	startScheduler();
+
+	// Le premier cycle de mesure est lancé sans attendre la première période de la tâche des sondes:
+	// après un démarrage sur le programme de l'EEPROM, la régulation dispose de mesures dès les premières secondes
+	startProbesCycle();
 }
 
 // Boucle principale
@@ -293,8 +588,13 @@ void loop(){
 	// A chaque itération de la boucle principale:
 	//
 
+	// On mesure la durée de chaque étape et de l'itération complète
+	unsigned long loopStart = micros();
+	unsigned long start = micros();
+
 	// On vérifie si une touche a été pressée
 	int keys = getKeys();
+	profiler.record(keysProbe, start);
 
 	// Les deux boutons ont été pressés
 	if(keys == ACTION_BOTH){
@@ -304,11 +604,8 @@ void loop(){
 	}
 
 	// Le bouton de gauche a été pressé, on affiche en boucle les paramètres de l'unité de germination
-	// après avoir rafraîchi les valeurs lues par les capteurs
-	else if(keys == ACTION_LEFT && lcdDisplay == -1){
-		getProbesValues();
-		lcdDisplay = 0;
-	}
+	// Les valeurs affichées sont celles du dernier cycle de mesure, sans nouvelle lecture des capteurs
+	else if(keys == ACTION_LEFT && lcdDisplay == -1) lcdDisplay = 0;
 
 	// Le bouton de droite a été pressé, on allume la lumière verte pour vérifier l'état des pousses
 	else if(keys == ACTION_RIGHT && !inspect) setInspect(true);
@@ -320,34 +617,61 @@ void loop(){
 		if(inspect) setInspect(false);
 	}
 
-	// On vérifie si on a un déclencheur d'évènement particulier à activer
-	keepEventCounters();
+	// On avance le cycle de mesure des sondes s'il est en cours
+	// Pendant une lecture du capteur d'air, l'envoi vers l'écran est suspendu: l'interruption qui cadence ses bits
+	// retarderait l'horodatage des fronts envoyés par le capteur
+	// Il l'est aussi avant une transaction sur le bus 1-Wire, qui masque les interruptions pendant chaque bit
+	// et déformerait l'octet en cours vers l'écran: la transaction attend la fin de cet octet
+	start = micros();
+	bool isBusNeeded = sensors.isBusNeeded();
+	if(isBusNeeded) lcd.hold(true);
+	if(!isBusNeeded || lcd.isIdle()) checkProbes();
+	lcd.hold(dht.isBusy() || sensors.isBusNeeded());
+	profiler.record(collectProbe, start);
+
+	// On exécute les tâches périodiques arrivées à échéance
+	// La boucle ne fait plus de pause, les périodes sont tenues par les échéances de l'ordonnanceur
+	scheduler.run();
 
 	// On vérifie si un message est arrivé sur le port USB
+	start = micros();
 	readSerial();
+	profiler.record(serialProbe, start);
 
-	// Et on patiente un tout petit peu...
-	delay(LOOP_DELAY);
+	// On continue l'envoi de l'historique des mesures et des temps d'exécution s'il est en cours
+	flushHistory();
+	flushStats();
+	profiler.record(loopProbe, loopStart);
 }
 
 // Procédure qui ajuste la vitesse du ventilateur
 // *speed* donne le pourcentage de la vitesse de rotation (0..100), 0 est éteint et 100 pleine vitesse
+// La vitesse n'est envoyée au PC qu'une fois la vitesse visée atteinte, pas à chaque pas de la rampe
 //
 void setFan(int speed){
 	if(fanSpeed != speed){
 		fanSpeed = speed;
 		analogWrite(FAN_CMD, analogLevel(speed));
-		sendUSBValue("FAN", speed);
+		if(fanSpeed == fanTarget) sendUSBValue(MSG_FAN, F("FAN"), speed);
 	}
 }
 
+// Procédure appelée chaque seconde qui rapproche la vitesse du ventilateur de la vitesse visée d'au plus FAN_SLEW_RATE %
+// Sous FAN_MIN_SPEED, le ventilateur calerait: il est alors démarré directement à cette vitesse ou arrêté
+//
+void checkFan(){
+	int speed = fanSpeed + constrain(fanTarget - fanSpeed, -FAN_SLEW_RATE, FAN_SLEW_RATE);
+	if(speed > 0 && speed < FAN_MIN_SPEED) speed = fanTarget > 0 ? FAN_MIN_SPEED : 0;
+	setFan(speed);
+}
+
 // Procédure qui démarre la résistance chauffante si elle n'est pas encore allumée
 //
 void heatOn(){
 	if(!isHeatOn){
 		digitalWrite(RELAY_1_CMD, LOW);
 		isHeatOn = true;
-		Serial.println("INFO:HEAT=ON");
+		sendUSBState(MSG_HEAT, F("HEAT"), true);
 	}
 }
 
@@ -357,7 +681,7 @@ void heatOff(){
 	if(isHeatOn){
 		digitalWrite(RELAY_1_CMD, HIGH);
 		isHeatOn = false;
-		Serial.println("INFO:HEAT=OFF");
+		sendUSBState(MSG_HEAT, F("HEAT"), false);
 	}
 }
 
@@ -367,7 +691,7 @@ void pumpOn(){
 	if(!isPumpOn){
 		digitalWrite(RELAY_2_CMD, LOW);
 		isPumpOn = true;
-		Serial.println("INFO:FLOW=ON");
+		sendUSBState(MSG_FLOW, F("FLOW"), true);
 	}
 }
 
@@ -377,7 +701,7 @@ void pumpOff(){
 	if(isPumpOn){
 		digitalWrite(RELAY_2_CMD, HIGH);
 		isPumpOn = false;
-		Serial.println("INFO:FLOW=OFF");
+		sendUSBState(MSG_FLOW, F("FLOW"), false);
 	}
 }
 
@@ -389,18 +713,18 @@ void pumpOff(){
 void setLED(int red, int green, int blue){
 
 	// On allume les composantes correspondantes via les GPIO
-	analogWrite(R_PIN, analogLevel(red));
-	analogWrite(G_PIN, analogLevel(green));
+	analogWrite(R_PIN, timerLevel(red));
+	analogWrite(G_PIN, timerLevel(green));
 	analogWrite(B_PIN, analogLevel(blue));
 
 	// On considère la lumière verte comme invisible par les plantes
 	if(red + blue == 0){
 		isLightOn = false;
-		Serial.println("INFO:LIGHT=OFF");
+		sendUSBState(MSG_LIGHT, F("LIGHT"), false);
 	}
 	else{
 		isLightOn = true;
-		Serial.println("INFO:LIGHT=ON");
+		sendUSBState(MSG_LIGHT, F("LIGHT"), true);
 	}
 }
 // Procédure utilisée pour allumer ou éteindre la composante verte des LEDs
@@ -418,7 +742,8 @@ void setInspect(bool state){
 void checkLED(){
 
 	// Si on est en mode inspection, pas besoin de vérifier
-	if(!inspect){
+	// Sans l'heure, on ne peut pas savoir si on est dans la plage d'éclairage: on laisse les lumières en l'état
+	if(!inspect && isTimeSet){
 
 		// Récupère le temps présent 
 		int now = 60 * hour() + minute();
@@ -449,43 +774,75 @@ void checkLED(){
 //
 void checkLCD(){
 
-	// Chaînes utilisée pour convertir des réels en chaîne de caractère
-	char string2Display[LCD_MAX_LENGTH] = "";
-	char float2String[FLOAT_MAX_LENGTH] = "";
-
 	// Si le compteur est plus grand ou égal à zéro, c'est que l'on doit afficher quelque chose
+	// Chaque écran reste affiché deux secondes: le programme, puis les trois mesures de chaque zone, puis l'heure
 	if(lcdDisplay >= 0){
 		lcdDisplay++;
-		switch(lcdDisplay){
-			case 1:
-				lcd.displayCenter("PROGRAMME", LCD::DISPLAY_TOP);
+		if(lcdDisplay % 2 == 1){
+			int screen = lcdDisplay / 2;
+			if(screen == 0){
+				lcd.displayCenter(F("PROGRAMME"), LCD::DISPLAY_TOP);
 				lcd.displayCenter(programName, LCD::DISPLAY_BOTTOM);
-			break;
-			case 3:
-				dtostrf(airTemperature, 5, 1, float2String); 
-				snprintf(string2Display, LCD_MAX_LENGTH, "%s%cC", float2String, LCD::SYMBOL_DEGREE);
-				lcd.displayCenter("TEMP AIR", LCD::DISPLAY_TOP);
-				lcd.displayCenter(string2Display, LCD::DISPLAY_BOTTOM);
-			break;
-			case 5:
-				dtostrf(airHumidity, 5, 1, float2String); 
-				snprintf(string2Display, LCD_MAX_LENGTH, "%s%c", float2String, 0x25);
-				lcd.displayCenter("HUMIDITE AIR", LCD::DISPLAY_TOP);
-				lcd.displayCenter(string2Display, LCD::DISPLAY_BOTTOM);
-			break;
-			case 7:
-				dtostrf(waterTemperature, 5, 1, float2String); 
-				snprintf(string2Display, LCD_MAX_LENGTH, "%s%cC", float2String, LCD::SYMBOL_DEGREE);
-				lcd.displayCenter("TEMP EAU", LCD::DISPLAY_TOP);
-				lcd.displayCenter(string2Display, LCD::DISPLAY_BOTTOM);
-			break;
-			case 9:
-				lcd.displayClock();
+			}
+			else if(screen <= 3 * sensors.getZoneCount()){
+				static const uint8_t quantities[] = { SENSOR_AIR_TEMPERATURE, SENSOR_AIR_HUMIDITY, SENSOR_WATER_TEMPERATURE };
+				displayMeasure((screen - 1) / 3, quantities[(screen - 1) % 3]);
+			}
+			else{
+				if(isTimeSet) lcd.displayClock();
+				else{
+					lcd.displayCenter(F("ATTENTE PC"), LCD::DISPLAY_TOP);
+					lcd.displayCenter(programName, LCD::DISPLAY_BOTTOM);
+				}
 				lcdDisplay = -1;
+			}
 		}
 	}
 }
 
+// Procédure qui affiche sur l'écran LCD la mesure d'une grandeur dans une zone, lue dans le registre des sondes
+// Le numéro de la zone n'est ajouté au titre que si l'unité en compte plusieurs
+// Une fois l'heure connue, on affiche aussi l'heure de la mesure, qui révèle une sonde dont la mesure n'est plus rafraîchie
+//	- zone: le numéro de la zone
+//	- quantity: SENSOR_WATER_TEMPERATURE, SENSOR_AIR_TEMPERATURE ou SENSOR_AIR_HUMIDITY
+//
+void displayMeasure(uint8_t zone, uint8_t quantity){
+
+	// Chaînes utilisée pour convertir la mesure en chaîne de caractère
+	char title[LCD_MAX_LENGTH] = "";
+	char string2Display[LCD_MAX_LENGTH] = "";
+	char fixed2String[FIXED_MAX_LENGTH] = "";
+
+	if(quantity == SENSOR_WATER_TEMPERATURE) strcpy_P(title, PSTR("TEMP EAU"));
+	else if(quantity == SENSOR_AIR_TEMPERATURE) strcpy_P(title, PSTR("TEMP AIR"));
+	else strcpy_P(title, PSTR("HUMIDITE AIR"));
+	if(sensors.getZoneCount() > 1){
+		size_t length = strlen(title);
+		snprintf_P(title + length, LCD_MAX_LENGTH - length, PSTR(" Z%d"), zone);
+	}
+
+	Sensors::Sample sample;
+	bool isUsable = sensors.getZoneSample(zone, quantity, sampleMaxAge, &sample);
+	formatMeasure(fixed2String, sample.value);
+	if(quantity == SENSOR_AIR_HUMIDITY) snprintf_P(string2Display, LCD_MAX_LENGTH, PSTR("%s%c"), fixed2String, 0x25);
+	else snprintf_P(string2Display, LCD_MAX_LENGTH, PSTR("%s%cC"), fixed2String, LCD::SYMBOL_DEGREE);
+	if(isUsable && isTimeSet){
+		size_t length = strlen(string2Display);
+		snprintf_P(string2Display + length, LCD_MAX_LENGTH - length, PSTR(" %02d:%02d"), hour(sample.clock), minute(sample.clock));
+	}
+	lcd.displayCenter(title, LCD::DISPLAY_TOP);
+	lcd.displayCenter(string2Display, LCD::DISPLAY_BOTTOM);
+}
+
+// Fonction qui écrit une mesure avec une décimale pour l'écran LCD, ou "--" si la mesure a échoué
+//	- buffer: le tampon qui reçoit le texte, d'au moins FIXED_MAX_LENGTH caractères
+//	- value: la mesure, en virgule fixe Q7
+//
+char* formatMeasure(char* buffer, fixed_t value){
+	if(value == FIXED_INVALID) return strcpy_P(buffer, PSTR("--"));
+	return Fixed::format(buffer, value, 1);
+}
+
 // Procédure appelée chaque seconde qui vérifie si on doit allumer ou éteindre la pompe d'arrosage
 //
 void checkPump(){
@@ -505,39 +862,71 @@ void checkPump(){
 	}
 }
 
-// Procédure qui permet de relever la température de l'air dans l'unité hydroponique
+// Procédure qui collecte les valeurs des sondes
+// On lance un cycle de mesure du registre: les sondes d'eau convertissent toutes en même temps pendant que
+// les capteurs d'air sont lus l'un après l'autre. Les valeurs sont collectées plus tard par checkProbes()
+// C'est la seule procédure qui interroge les capteurs: tout le reste du programme lit les mesures dans le registre
+// Si un cycle est déjà en cours, on le laisse se terminer
 //
-void getAirTemperature(){
-	airTemperature = dht.readTemperature();
+void getProbesValues(){
+	sensors.startCycle();
 }
 
-// Procédure qui permet de relever l'humidité de l'air dans l'unité hydroponique
+// Procédure appelée à chaque itération qui avance le cycle de mesure des sondes
+// A la fin du cycle, on signale au PC tout changement dans la liste des sondes en panne
+// Si la collecte a été demandée par le cycle de mesure, on corrige puis on envoie les valeurs au PC
 //
-void getAirHumidity(){
-	airHumidity = dht.readHumidity();
-}
+void checkProbes(){
+	if(sensors.update()){
+		uint16_t mask = sensors.getDownMask();
+		if(mask != probesDown){
+			probesDown = mask;
+			sendUSBValue(MSG_PROBES_DOWN, F("PROBES_DOWN"), (int)mask);
+		}
+	}
+	if(isFeedbackPending && !sensors.isBusy()){
+		isFeedbackPending = false;
 
-// Procédure qui permet de relever la température de l'eau du bassin d'hydroculture
-//
-void getWaterTemperature(){
-	waterSensor.requestTemperatures();
-	waterTemperature = waterSensor.getTempCByIndex(0);
+		// On prend une action corrective si une valeur dépasse les limites
+		unsigned long start = micros();
+		provideFeedbacks();
+		profiler.record(feedbackProbe, start);
+
+		// On enregistre les mesures provenant des différentes sondes dans l'historique
+		start = micros();
+		sendProbesValues();
+		profiler.record(recordProbe, start);
+	}
 }
 
-// Procédure qui collecte les valeurs des sondes
+// Fonction qui retourne la mesure de la zone la plus basse (lowest) ou la plus haute pour une grandeur
+// L'unité n'a qu'une résistance et qu'un ventilateur: ils sont pilotés d'après la zone la plus éloignée de sa consigne
+// Retourne FIXED_INVALID si aucune zone n'a de mesure utilisable: absente, trop ancienne ou d'une sonde en panne
+//	- quantity: SENSOR_WATER_TEMPERATURE, SENSOR_AIR_TEMPERATURE ou SENSOR_AIR_HUMIDITY
 //
-void getProbesValues(){
-	getAirTemperature();
-	getAirHumidity();
-	getWaterTemperature();
+fixed_t getWorstZone(uint8_t quantity, bool lowest){
+	fixed_t worst = FIXED_INVALID;
+	for(uint8_t zone = 0; zone < sensors.getZoneCount(); zone++){
+		fixed_t value = sensors.getZoneValue(zone, quantity, sampleMaxAge);
+		if(value != FIXED_INVALID && (worst == FIXED_INVALID || (lowest ? value < worst : value > worst))) worst = value;
+	}
+	return worst;
 }
 
-// Procédure qui envoie les valeurs des sondes au PC de surveillance
+// Procédure qui enregistre les valeurs des sondes, horodatées et en centièmes, dans l'historique des mesures
+// On enregistre une mesure par zone, lue dans le registre: la moyenne des sondes de la zone dont la mesure est utilisable
+// Une valeur inconnue ou trop ancienne est enregistrée à -256,00 (FIXED_INVALID), hors de la plage de toutes les sondes
+// Elles sont envoyées au PC par lots, quand il le demande ou dès que HISTORY_WATERMARK mesures sont en attente
+// Le PC les demande à chaque période de mesure pour suivre les valeurs en direct, le seuil ne sert qu'en son absence
 //
 void sendProbesValues(){
-	sendUSBValue("AIR_TEMP", airTemperature, 5, 2);
-	sendUSBValue("AIR_HUM", airHumidity, 5, 2);
-	sendUSBValue("WATER_TEMP", waterTemperature, 5, 2);
+	for(uint8_t zone = 0; zone < sensors.getZoneCount(); zone++){
+		history.push(now(), zone,
+			Fixed::toHundredths(sensors.getZoneValue(zone, SENSOR_AIR_TEMPERATURE, sampleMaxAge)),
+			Fixed::toHundredths(sensors.getZoneValue(zone, SENSOR_AIR_HUMIDITY, sampleMaxAge)),
+			Fixed::toHundredths(sensors.getZoneValue(zone, SENSOR_WATER_TEMPERATURE, sampleMaxAge)));
+	}
+	if(history.getPending() >= HISTORY_WATERMARK) isHistoryFlushing = true;
 }
 
 // Procédure qui prend les actions correctives si les paramètres sous contrôles
@@ -545,13 +934,69 @@ void sendProbesValues(){
 //
 void provideFeedbacks(){
 
-	// Correction de l'air
-	if(airTemperature >= airHigh) setFan(100);
-	if(airTemperature <= airHigh - TEMPERATURE_TOLERENCE) setFan(0);
+	// Correction de l'air: la vitesse demandée croît avec la température, de l'arrêt au milieu de la plage airLow..airHigh
+	// jusqu'à la pleine vitesse à airHigh; dans la moitié basse de la plage, ventiler ne ferait que refroidir l'eau
+	// Le capteur ne donnant que des degrés entiers, la demande est lissée sur FAN_SMOOTHING mesures,
+	// en pourcentage Q7 pour que le lissage garde des fractions de pour cent
+	// Le ventilateur arrêté ne démarre qu'une fois FAN_MIN_SPEED demandé et ne s'arrête que sous la moitié de cette vitesse
+	// Avec plusieurs zones, on ventile d'après la zone la plus chaude
+	fixed_t airTemperature = getWorstZone(SENSOR_AIR_TEMPERATURE, false);
+	if(airLow != FIXED_INVALID && airHigh > airLow && airTemperature != FIXED_INVALID){
+		fixed_t middle = ((long)airLow + airHigh) / 2;
+		long demand = constrain(((long)airTemperature - middle) * 100 * FIXED_ONE / (airHigh - middle), 0L, 100L * FIXED_ONE);
+		fanDemand += (demand - fanDemand) / FAN_SMOOTHING;
+		int target = (fanDemand + FIXED_ONE / 2) >> FIXED_SHIFT;
+		if(target < (fanTarget == 0 ? FAN_MIN_SPEED : FAN_MIN_SPEED / 2)) target = 0;
+		else if(target < FAN_MIN_SPEED) target = FAN_MIN_SPEED;
+		fanTarget = target;
+	}
 
-	// Correction de l'eau
-	if(waterTemperature <= waterLow) heatOn();
-	if(waterTemperature >= waterHigh) heatOff();
+	// La température de l'eau est régulée en continu par checkHeat()
+}
+
+// Procédure appelée chaque seconde qui pilote la résistance chauffante par modulation de largeur d'impulsion lente
+// Au début de chaque fenêtre, le PID calcule la part de la fenêtre pendant laquelle la résistance chauffe,
+// visant le milieu de la plage de température de l'eau du programme
+// Une marche ou un arrêt plus court que heatMinimum est supprimé pour ménager le relais
+// La chauffe est placée alternativement à la fin puis au début des fenêtres: deux fenêtres de puissance voisine
+// se rejoignent alors sans arrêt entre elles, et le relais ne fait qu'un cycle toutes les deux fenêtres
+// Sans programme ou sans mesure de l'eau valide et récente, la résistance est coupée immédiatement et le PID repart de zéro
+// Avec plusieurs zones, on chauffe d'après la zone la plus froide
+//
+void checkHeat(){
+	fixed_t waterTemperature = getWorstZone(SENSOR_WATER_TEMPERATURE, true);
+	if(waterLow == FIXED_INVALID || waterTemperature == FIXED_INVALID){
+		waterPID.reset();
+		heatSecond = 0;
+		heatOnTime = 0;
+		heatOff();
+		return;
+	}
+	if(heatSecond == 0){
+		isHeatAtEnd = !isHeatAtEnd;
+		long setpoint = Fixed::toHundredths((long)waterLow + waterHigh) / 2;
+		long duty = waterPID.compute(setpoint, Fixed::toHundredths(waterTemperature), heatWindow);
+		heatOnTime = (duty * heatWindow + PID_OUTPUT_MAX / 2) / PID_OUTPUT_MAX;
+		if(heatOnTime < heatMinimum) heatOnTime = 0;
+		if(heatWindow - heatOnTime < heatMinimum) heatOnTime = heatWindow;
+		sendUSBValue(MSG_HEAT_DUTY, F("HEAT_DUTY"), (int)duty);
+	}
+	if(isHeatAtEnd ? heatSecond >= heatWindow - heatOnTime : heatSecond < heatOnTime) heatOn();
+	else heatOff();
+	heatSecond = (heatSecond + 1) % heatWindow;
+}
+
+// Procédure qui règle le PID de l'eau d'après le programme et envoie ses gains et sa fenêtre au PC
+// La fenêtre en cours est abandonnée: la suivante commence avec les nouveaux réglages
+//
+void applyHeatSettings(){
+	waterPID.setGains(pidKp, pidKi, pidKd);
+	heatSecond = 0;
+	sendUSBValue(MSG_PID_KP, F("PID_KP"), pidKp, PID_GAIN_SHIFT, 2);
+	sendUSBValue(MSG_PID_KI, F("PID_KI"), pidKi, PID_GAIN_SHIFT, 2);
+	sendUSBValue(MSG_PID_KD, F("PID_KD"), pidKd, PID_GAIN_SHIFT, 2);
+	sendUSBValue(MSG_HEAT_WINDOW, F("HEAT_WINDOW"), heatWindow);
+	sendUSBValue(MSG_HEAT_MIN, F("HEAT_MIN"), heatMinimum);
 }
 
 // Fonction qui renvoie la valeur correspondante aux touches enfoncées
@@ -569,156 +1014,593 @@ int getKeys(){
 int analogLevel(int percentage){
 	if(percentage > 100) return 255;
 	if(percentage < 0) return 0;
-	return percentage * 2.55;
+	return percentage * 255 / 100;
+}
+
+// Fonction qui adapte un pourcentage à la valeur maximale du Timer1, qui cadence aussi la liaison de l'écran LCD
+// Les composantes Rouge (broche 9) et Verte (broche 10) sont sur ce timer: leur rapport cyclique va de 0 à LCD_TIMER_TOP
+//
+int timerLevel(int percentage){
+	return (long)analogLevel(percentage) * LCD_TIMER_TOP(LCD_SPEED) / 255;
 }
 
 // Ecoute le port série et analyse les messages reçus
+// Les octets disponibles sont assemblés en lignes sans attendre la suite d'un message incomplet
+// Chaque ligne est découpée sur place en commande et paramètre, sans allocation dynamique
 //
 void readSerial(){
+	SerialLine::Token command;
+	SerialLine::Token param;
+
+	// On traite toutes les lignes complètes présentes sur le port série (la fin est toujours délimitée par un "\n")
+	// Si on a trouvé au moins une commande à analyser, on l'exécute si elle existe, avec un paramètre vide si la ligne n'a pas de ":"
+	// Une ligne tronquée n'est jamais exécutée: un programme complet trop long est refusé pour que le PC ne le renvoie pas
+	// en attendant indéfiniment une réponse, les autres commandes sont ignorées
+	while(serialLine.read()){
+		serialLine.split(':', &command, &param);
+		if(!serialLine.isTruncated()) runCommand(&command, &param);
+		else if(tokenHash(&command) == commandHash("SET_PROGRAM_BLOCK")) Serial.println(F("INIT:PROGRAM_BLOCK_ERROR"));
+	}
+}
 
-	// Si il y a des données présentes sur le port série
-	if(Serial.available() > 0){
+// Procédure qui exécute une commande reçue
+// L'empreinte de la commande est recherchée par dichotomie dans la table des commandes, rangée par empreinte croissante
+// Une seule comparaison de chaînes, avec le nom conservé en mémoire flash, confirme la commande trouvée:
+// une commande inconnue qui aurait la même empreinte qu'une commande de la table est ainsi ignorée
+// Le paramètre est converti suivant le type déclaré avant d'être passé à la procédure de la commande
+//
+void runCommand(const SerialLine::Token* command, const SerialLine::Token* param){
+	uint32_t hash = tokenHash(command);
+	uint8_t low = 0;
+	uint8_t high = COMMAND_COUNT;
+	while(low < high){
+		uint8_t i = (low + high) / 2;
+		uint32_t entryHash = pgm_read_dword(&commands[i].hash);
+		if(entryHash < hash) low = i + 1;
+		else if(entryHash > hash) high = i;
+		else{
+			if(strcmp_P(command->text, commands[i].name) != 0) return;
+			CommandArg arg;
+			switch(pgm_read_byte(&commands[i].type)){
+				case ARG_INT:
+					arg.asInt = strtol(param->text, NULL, 10);
+				break;
+				case ARG_FIXED:
+					arg.asInt = Fixed::parse(param->text, NULL);
+				break;
+				case ARG_TIME:
+					arg.asInt = parseMinutes(param->text);
+				break;
+				default:
+					arg.asString = param->text;
+			}
+			CommandHandler handler = (CommandHandler)pgm_read_ptr(&commands[i].handler);
+			handler(&arg);
+			return;
+		}
+	}
+}
 
-		// On les lit (la fin est supposée toujours être délimitée par un "\n")
-		String readData = Serial.readStringUntil('\n');
+// Fonction qui calcule l'empreinte FNV-1a d'une commande reçue, identique à celle calculée à la compilation par commandHash()
+//
+uint32_t tokenHash(const SerialLine::Token* token){
+	uint32_t hash = FNV_OFFSET;
+	for(uint8_t i = 0; i < token->length; i++){
+		hash ^= (uint8_t)token->text[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
 
-		// On extrait la position du séparateur afin d'isoler la commande de son paramètre
-		int separator = readData.indexOf(':');
+/*
+** Dans la section qui suit, on déroule les actions correspondantes aux commandes de la table des commandes
+*/
 
-		// Si on a trouvé au moins une commande à analyser, on vérifie et on l'exécute si elle existe
-		if(separator != -1){
+void setProgram(const CommandArg* arg){
+	strncpy(programName, arg->asString, LCD_MAX_LENGTH - 1);
+	programName[LCD_MAX_LENGTH - 1] = '\0';
+	lcd.displayCenter(F("PROGRAMME"), LCD::DISPLAY_TOP);
+	lcd.displayCenter(programName, LCD::DISPLAY_BOTTOM);
+}
 
-			// On sépare la commande des données
-			String command = readData.substring(0, separator);
-			String param = readData.substring(separator + 1);
+void setClock(const CommandArg* arg){
+	setTime((time_t)arg->asInt);
+	isTimeSet = true;
+}
 
-			/*
-			** Dans la section qui suit, on déroule les actions correspondantes à la commande à exécuter
-			*/
+void setRedLevel(const CommandArg* arg){
+	redOn = arg->asInt;
+}
 
-			if(command == "SET_PROGRAM"){
-				param.toCharArray(programName, LCD_MAX_LENGTH);
-				lcd.displayCenter("PROGRAMME", LCD::DISPLAY_TOP);
-				lcd.displayCenter(programName, LCD::DISPLAY_BOTTOM);
-				initPhase = false;
-			}
-			else if(command == "SET_TIME"){
-				setTime(param.toInt());
-				isTimeSet = true;
-			}
-			else if(command == "SET_RED_LEVEL"){
-				redOn = param.toInt();
-			}
-			else if(command == "SET_GREEN_LEVEL"){
-				greenOn = param.toInt();
-			}
-			else if(command == "SET_BLUE_LEVEL"){
-				blueOn = param.toInt();
-			}
-			else if(command == "SET_LIGHT_ON"){
-				int hours = param.substring(0, 2).toInt();
-				int minutes = param.substring(3, 5).toInt();
-				lightOn = 60 * hours + minutes;
-			}
-			else if(command == "SET_LIGHT_OFF"){
-				int hours = param.substring(0, 2).toInt();
-				int minutes = param.substring(3, 5).toInt();
-				lightOff = 60 * hours + minutes;
-			}
-			else if(command == "SET_FLOW_ON"){
-				flowOn = 60 * param.toInt();
-			}
-			else if(command == "SET_FLOW_OFF"){
-				flowOff = 60 * param.toInt();
-			}
-			else if(command == "SET_WATER_LOW"){
-				waterLow = param.toFloat();
-			}
-			else if(command == "SET_WATER_HIGH"){
-				waterHigh = param.toFloat();
-			}
-			else if(command == "SET_AIR_LOW"){
-				airLow = param.toFloat();
-			}
-			else if(command == "SET_AIR_HIGH"){
-				airHigh = param.toFloat();
-			}
-		}
+void setGreenLevel(const CommandArg* arg){
+	greenOn = arg->asInt;
+}
+
+void setBlueLevel(const CommandArg* arg){
+	blueOn = arg->asInt;
+}
+
+void setLightOn(const CommandArg* arg){
+	lightOn = arg->asInt;
+}
+
+void setLightOff(const CommandArg* arg){
+	lightOff = arg->asInt;
+}
+
+void setFlowOn(const CommandArg* arg){
+	flowOn = 60 * arg->asInt;
+}
+
+void setFlowOff(const CommandArg* arg){
+	flowOff = 60 * arg->asInt;
+}
+
+void setWaterLow(const CommandArg* arg){
+	waterLow = constrain(arg->asInt, TEMPERATURE_MIN, TEMPERATURE_MAX);
+}
+
+void setWaterHigh(const CommandArg* arg){
+	waterHigh = constrain(arg->asInt, TEMPERATURE_MIN, TEMPERATURE_MAX);
+}
+
+void setAirLow(const CommandArg* arg){
+	airLow = constrain(arg->asInt, TEMPERATURE_MIN, TEMPERATURE_MAX);
+}
+
+void setAirHigh(const CommandArg* arg){
+	airHigh = constrain(arg->asInt, TEMPERATURE_MIN, TEMPERATURE_MAX);
+}
+
+// Commande qui choisit le protocole utilisé pour envoyer les mesures: BINARY pour les trames binaires, TEXT sinon
+// Le choix est acquitté par INIT:TELEMETRY_BINARY ou INIT:TELEMETRY_TEXT; un PC qui ne le demande pas reste en mode texte
+//
+void setTelemetry(const CommandArg* arg){
+	isBinaryTelemetry = strcmp_P(arg->asString, PSTR("BINARY")) == 0;
+	Serial.println(isBinaryTelemetry ? F("INIT:TELEMETRY_BINARY") : F("INIT:TELEMETRY_TEXT"));
+}
+
+// Commande qui charge en une seule trame le programme de germination complet
+// Format: SET_PROGRAM_BLOCK:NOM;HEURE;ROUGE;VERT;BLEU;ALLUMAGE;EXTINCTION;ARROSAGE;REPOS;EAU_BASSE;EAU_HAUTE;AIR_BAS;AIR_HAUT;KP;KI;KD;FENETRE;MINIMUM*CRC
+// La trame n'est appliquée que si elle est intacte et complète: on ne démarre jamais avec un programme à moitié chargé
+// Elle est acquittée une seule fois, par INIT:PROGRAM_BLOCK_OK, ou refusée par INIT:PROGRAM_BLOCK_ERROR
+//
+void setProgramBlock(const CommandArg* arg){
+	ProgramBlock block;
+	if(!parseProgramBlock(arg->asString, &block)){
+		Serial.println(F("INIT:PROGRAM_BLOCK_ERROR"));
+		return;
+	}
+	strcpy(programName, block.name);
+	setTime((time_t)block.time);
+	redOn = block.red;
+	greenOn = block.green;
+	blueOn = block.blue;
+	lightOn = block.lightOn;
+	lightOff = block.lightOff;
+	flowOn = 60 * block.flowOn;
+	flowOff = 60 * block.flowOff;
+	waterLow = block.waterLow;
+	waterHigh = block.waterHigh;
+	airLow = block.airLow;
+	airHigh = block.airHigh;
+	pidKp = block.pidKp;
+	pidKi = block.pidKi;
+	pidKd = block.pidKd;
+	heatWindow = block.heatWindow;
+	heatMinimum = block.heatMinimum;
+	isTimeSet = true;
+	isProgramSynced = true;
+	saveProgram();
+
+	// Pendant l'initialisation, on affiche le programme chargé
+	// Après un démarrage autonome, on règle l'horloge qui était inconnue jusqu'ici et on l'affiche si l'écran est libre
+	if(initPhase){
+		initPhase = false;
+		lcd.displayCenter(F("PROGRAMME"), LCD::DISPLAY_TOP);
+		lcd.displayCenter(programName, LCD::DISPLAY_BOTTOM);
+	}
+	else{
+		lcd.setClock();
+		if(lcdDisplay == -1) lcd.displayClock();
+	}
+	Serial.println(F("INIT:PROGRAM_BLOCK_OK"));
+	applyHeatSettings();
+}
+
+// Fonction qui vérifie et découpe la trame du programme complet dans une structure
+// Le CRC16 est celui du bus 1-Wire (OneWire::crc16), calculé sur tout ce qui précède l'étoile
+// et transmis en BLOCK_CRC_LENGTH chiffres hexadécimaux
+// Retourne false si le CRC est faux, s'il manque un champ ou si une valeur est hors limites
+//
+bool parseProgramBlock(const char* text, ProgramBlock* block){
+
+	// On vérifie d'abord l'intégrité de la trame
+	const char* star = strchr(text, '*');
+	if(star == NULL || strlen(star + 1) != BLOCK_CRC_LENGTH) return false;
+	if(OneWire::crc16((const uint8_t*)text, star - text) != strtoul(star + 1, NULL, 16)) return false;
+
+	// Le nom du programme doit tenir sur une ligne du LCD
+	const char* cursor = strchr(text, ';');
+	if(cursor == NULL || cursor == text || cursor - text >= LCD_MAX_LENGTH) return false;
+	memcpy(block->name, text, cursor - text);
+	block->name[cursor - text] = '\0';
+	cursor++;
+
+	// Puis on lit chaque champ dans l'ordre, en vérifiant ses limites
+	long time;
+	if(!parseBlockLong(&cursor, 0, LONG_MAX, &time)) return false;
+	block->time = time;
+	if(!parseBlockLong(&cursor, 0, 100, &block->red)) return false;
+	if(!parseBlockLong(&cursor, 0, 100, &block->green)) return false;
+	if(!parseBlockLong(&cursor, 0, 100, &block->blue)) return false;
+	if(!parseBlockTime(&cursor, &block->lightOn)) return false;
+	if(!parseBlockTime(&cursor, &block->lightOff)) return false;
+	if(!parseBlockLong(&cursor, 1, INT_MAX / 60, &block->flowOn)) return false;
+	if(!parseBlockLong(&cursor, 1, INT_MAX / 60, &block->flowOff)) return false;
+	if(!parseBlockFixed(&cursor, FIXED_SHIFT, TEMPERATURE_MIN, TEMPERATURE_MAX, &block->waterLow)) return false;
+	if(!parseBlockFixed(&cursor, FIXED_SHIFT, TEMPERATURE_MIN, TEMPERATURE_MAX, &block->waterHigh)) return false;
+	if(!parseBlockFixed(&cursor, FIXED_SHIFT, TEMPERATURE_MIN, TEMPERATURE_MAX, &block->airLow)) return false;
+	if(!parseBlockFixed(&cursor, FIXED_SHIFT, TEMPERATURE_MIN, TEMPERATURE_MAX, &block->airHigh)) return false;
+	if(!parseBlockFixed(&cursor, PID_GAIN_SHIFT, 0, (long)PID_KP_MAX << PID_GAIN_SHIFT, &block->pidKp)) return false;
+	if(!parseBlockFixed(&cursor, PID_GAIN_SHIFT, 0, (long)PID_KI_MAX << PID_GAIN_SHIFT, &block->pidKi)) return false;
+	if(!parseBlockFixed(&cursor, PID_GAIN_SHIFT, 0, (long)PID_KD_MAX << PID_GAIN_SHIFT, &block->pidKd)) return false;
+	if(!parseBlockLong(&cursor, HEAT_WINDOW_MIN, HEAT_WINDOW_MAX, &block->heatWindow)) return false;
+	if(!parseBlockLong(&cursor, 0, block->heatWindow / 2, &block->heatMinimum)) return false;
+
+	// Le dernier champ doit se terminer exactement sur l'étoile et les plages de températures doivent être cohérentes
+	return cursor == star + 1 && block->waterLow < block->waterHigh && block->airLow < block->airHigh;
+}
+
+// Fonction qui lit un entier dans la trame du programme complet et avance le curseur au champ suivant
+// Retourne false si le champ n'est pas un entier compris entre low et high, terminé par ";" ou "*"
+//
+bool parseBlockLong(const char** cursor, long low, long high, long* value){
+	char* end;
+	*value = strtol(*cursor, &end, 10);
+	if(end == *cursor || (*end != ';' && *end != '*') || *value < low || *value > high) return false;
+	*cursor = end + 1;
+	return true;
+}
+
+// Fonction qui lit un nombre décimal dans la trame du programme complet, le convertit en virgule fixe
+// avec shift bits de fraction et avance le curseur au champ suivant
+// Retourne false si le champ n'est pas un nombre compris entre low et high, terminé par ";" ou "*"
+//
+bool parseBlockFixed(const char** cursor, uint8_t shift, long low, long high, long* value){
+	char* end;
+	*value = Fixed::parse(*cursor, &end, shift);
+	if(end == *cursor || (*end != ';' && *end != '*') || *value < low || *value > high) return false;
+	*cursor = end + 1;
+	return true;
+}
+
+// Fonction qui lit une heure au format HH:MM dans la trame du programme complet et la convertit en minutes depuis minuit
+// Retourne false si le champ n'est pas une heure valide terminée par ";" ou "*"
+//
+bool parseBlockTime(const char** cursor, long* value){
+	char* end;
+	long hours = strtol(*cursor, &end, 10);
+	if(end == *cursor || *end != ':' || hours < 0 || hours > 23) return false;
+	const char* start = end + 1;
+	long minutes = strtol(start, &end, 10);
+	if(end == start || (*end != ';' && *end != '*') || minutes < 0 || minutes > 59) return false;
+	*value = 60 * hours + minutes;
+	*cursor = end + 1;
+	return true;
+}
+
+// Procédure qui scrute le port USB pendant la durée donnée, utilisée à la place de delay() pendant l'initialisation
+// Le tampon de réception matériel ne fait que 64 octets: sans cela, une trame plus longue serait tronquée
+// On sort dès que le programme a été chargé
+//
+void listenSerial(unsigned long duration){
+	unsigned long start = millis();
+	while(initPhase && millis() - start < duration){
+		readSerial();
+	}
+}
+
+// Procédure qui conserve le programme de germination en cours dans l'EEPROM
+// EEPROM.put() ne réécrit que les octets qui ont changé: renvoyer le même programme n'use pas l'EEPROM
+//
+void saveProgram(){
+	StoredProgram stored;
+	stored.version = EEPROM_PROGRAM_VERSION;
+	strcpy(stored.name, programName);
+	stored.red = redOn;
+	stored.green = greenOn;
+	stored.blue = blueOn;
+	stored.lightOn = lightOn;
+	stored.lightOff = lightOff;
+	stored.flowOn = flowOn;
+	stored.flowOff = flowOff;
+	stored.waterLow = waterLow;
+	stored.waterHigh = waterHigh;
+	stored.airLow = airLow;
+	stored.airHigh = airHigh;
+	stored.pidKp = pidKp;
+	stored.pidKi = pidKi;
+	stored.pidKd = pidKd;
+	stored.heatWindow = heatWindow;
+	stored.heatMinimum = heatMinimum;
+	stored.crc = OneWire::crc16((const uint8_t*)&stored, offsetof(StoredProgram, crc));
+	EEPROM.put(EEPROM_PROGRAM_ADDRESS, stored);
+}
+
+// Fonction qui restaure le programme de germination conservé dans l'EEPROM
+// Retourne false si l'EEPROM ne contient pas de programme de la version courante ou si son CRC est faux
+//
+bool restoreProgram(){
+	StoredProgram stored;
+	EEPROM.get(EEPROM_PROGRAM_ADDRESS, stored);
+	if(stored.version != EEPROM_PROGRAM_VERSION) return false;
+	if(OneWire::crc16((const uint8_t*)&stored, offsetof(StoredProgram, crc)) != stored.crc) return false;
+	memcpy(programName, stored.name, LCD_MAX_LENGTH);
+	programName[LCD_MAX_LENGTH - 1] = '\0';
+	redOn = stored.red;
+	greenOn = stored.green;
+	blueOn = stored.blue;
+	lightOn = stored.lightOn;
+	lightOff = stored.lightOff;
+	flowOn = stored.flowOn;
+	flowOff = stored.flowOff;
+	waterLow = stored.waterLow;
+	waterHigh = stored.waterHigh;
+	airLow = stored.airLow;
+	airHigh = stored.airHigh;
+	pidKp = stored.pidKp;
+	pidKi = stored.pidKi;
+	pidKd = stored.pidKd;
+	heatWindow = stored.heatWindow;
+	heatMinimum = stored.heatMinimum;
+	return true;
+}
+
+// Procédure appelée régulièrement qui redemande le programme au PC tant qu'il n'a pas été reçu
+// Après un démarrage sur le programme de l'EEPROM, c'est ainsi que l'unité récupère l'heure et un éventuel nouveau programme
+//
+void requestProgram(){
+	if(!isProgramSynced) Serial.println(F("INIT:GET_PROGRAM_BLOCK"));
+}
+
+// Fonction qui convertit une heure au format HH:MM en nombre de minutes depuis minuit
+//	- text: l'heure à convertir, les heures sur les deux premiers caractères et les minutes à partir du quatrième
+//
+int parseMinutes(const char* text){
+	int hours = atoi(text);
+	int minutes = strlen(text) > 3 ? atoi(text + 3) : 0;
+	return 60 * hours + minutes;
+}
+
+// Procédure qui envoie un état ON/OFF au Raspberry
+// La phrase envoyée est du type INFO:parameter=ON, ou une trame binaire de valeur 1 ou 0 en mode binaire
+// Le nom du paramètre est conservé en mémoire flash, déclaré avec F("...")
+//
+void sendUSBState(uint8_t id, const __FlashStringHelper* parameter, bool state){
+	if(isBinaryTelemetry) telemetry.send(id, state ? 1 : 0);
+	else{
+		Serial.print(F("INFO:"));
+		Serial.print(parameter);
+		Serial.print('=');
+		Serial.println(state ? F("ON") : F("OFF"));
 	}
 }
 
 // Procédure qui envoie un paramètre de type entier au Raspberry
-// La phrase envoyée est du type ARDUINO_NAME:parameter:value
+// La phrase envoyée est du type INFO:parameter=value, ou une trame binaire identifiée par id en mode binaire
 //
-void sendUSBValue(const char* parameter, int value){
-	char string2Send[SERIAL_MAX_LENGTH] = "";
-	snprintf(string2Send, SERIAL_MAX_LENGTH, "INFO:%s=%d", parameter, value);
-	Serial.println(string2Send);
+void sendUSBValue(uint8_t id, const __FlashStringHelper* parameter, int value){
+	if(isBinaryTelemetry) telemetry.send(id, value);
+	else{
+		Serial.print(F("INFO:"));
+		Serial.print(parameter);
+		Serial.print('=');
+		Serial.println(value);
+	}
 }
 
-// Procédure qui envoie un paramètre de type réel au Raspberry
-// La conversion se fait par la fonction dtostfr car le format %f de la commande snprintf n'est pas supporté par l'Arduino
-// Le paramètre width donne la longueur totale du float converti, en incluant le signe, la virgule et les décimaux
+// Procédure qui envoie un paramètre en virgule fixe au Raspberry
+// La conversion en texte se fait par Fixed::format, sans passer par les réels
+// Le paramètre shift donne le nombre de bits de la partie fractionnaire de value
 // Le paramètre precision donne le nombre de chiffres derrière la virgule
-// La phrase envoyée est du type ARDUINO_NAME:parameter:value
+// La phrase envoyée est du type INFO:parameter=value
+// En mode binaire, aucune conversion en texte n'est faite: la valeur part en centièmes
 //
-void sendUSBValue(const char* parameter, float value, int width, int precision){
-	char string2Send[SERIAL_MAX_LENGTH] = "";
-	char float2String[FLOAT_MAX_LENGTH] = "";
-	dtostrf(value, width, precision, float2String); 
-	snprintf(string2Send, SERIAL_MAX_LENGTH, "INFO:%s=%s", parameter, float2String);
-	Serial.println(string2Send);
+void sendUSBValue(uint8_t id, const __FlashStringHelper* parameter, long value, uint8_t shift, uint8_t precision){
+	if(isBinaryTelemetry) telemetry.send(id, Fixed::toHundredths(value, shift));
+	else{
+		char fixed2String[FIXED_MAX_LENGTH] = "";
+		Fixed::format(fixed2String, value, precision, 0, shift);
+		Serial.print(F("INFO:"));
+		Serial.print(parameter);
+		Serial.print('=');
+		Serial.println(fixed2String);
+	}
 }
 
-// Procédure appelée à chaque itération de la boucle principale
-// Vérifie l'état des compteurs d'événements par rapport à l'état du système
-// Prend les mesures adéquates lors de transitions
+// Procédure qui enregistre les tâches périodiques auprès de l'ordonnanceur
+// La pompe et la résistance chauffante rattrapent chaque seconde manquée pour que leurs plages de fonctionnement et de repos gardent leur durée réelle
+// Les autres tâches abandonnent les échéances manquées pour ne pas s'exécuter en rafale après un retard
 //
-void keepEventCounters(){
+void startScheduler(){
 
-	// Décompte le temps qui s'écoule pour les différents déclencheurs
-	// Si le temps est écoulé, pour un déclencheur, on effectue les opérations liées à ce déclencheur
-	// Après avoir déroulé les opérations, on reprogramme le déclencheur
-	secondDelay -= LOOP_DELAY;
-	minuteDelay -= LOOP_DELAY;
-	quarterDelay -= LOOP_DELAY;
+	// La durée d'exécution des tâches qui ont une sonde est mesurée par le profileur
+	scheduler.setProfiler(&profiler);
 
-	// Chaque seconde...
-	if(secondDelay == 0){
+	// Chaque seconde, on vérifie l'état de la pompe, de la résistance chauffante, du ventilateur, de l'éclairage et de l'écran LCD
+	scheduler.setProbe(scheduler.addTask(checkPump, SECOND_DELAY, Scheduler::CATCH_UP), profiler.addProbe(F("PUMP")));
+	scheduler.setProbe(scheduler.addTask(checkHeat, SECOND_DELAY, Scheduler::CATCH_UP), profiler.addProbe(F("HEAT")));
+	scheduler.setProbe(scheduler.addTask(checkFan, SECOND_DELAY, Scheduler::SKIP), profiler.addProbe(F("FAN")));
+	scheduler.setProbe(scheduler.addTask(checkLED, SECOND_DELAY, Scheduler::SKIP), profiler.addProbe(F("LED")));
+	scheduler.setProbe(scheduler.addTask(checkLCD, SECOND_DELAY, Scheduler::SKIP), profiler.addProbe(F("LCD")));
 
-		// On vérifie l'état de la pompe et on adapte si on change de plage
-		checkPump();
+	// Chaque minute (ou à la période demandée par le PC), on mesure les sondes, on corrige et on enregistre les mesures
+	probesTask = scheduler.addTask(startProbesCycle, MINUTE_DELAY, Scheduler::SKIP);
+	scheduler.setProbe(probesTask, profiler.addProbe(F("PROBES")));
 
-		// On vérifie si on doit allumer ou éteindre les LEDs
-		checkLED();
+	// Tant que le programme n'a pas été confirmé par le PC, on le redemande régulièrement
+	scheduler.addTask(requestProgram, PROGRAM_SYNC_DELAY, Scheduler::SKIP);
 
-		// On vérifie si on doit afficher les paramètres de l'unité sur l'écran LCD
-		checkLCD();
+	// Chaque quart d'heure, on rapporte les dépassements d'échéances, l'état de l'écran LCD et celui de la mémoire
+	scheduler.addTask(sendSchedulerStats, QUARTER_DELAY, Scheduler::SKIP);
+	scheduler.addTask(sendMemoryStats, QUARTER_DELAY, Scheduler::SKIP);
+}
+
+// Procédure qui enregistre les sondes du profileur placées dans la boucle principale
+// Les noms font au plus STATS_NAME_LENGTH caractères pour que chaque ligne envoyée par flushStats() tienne dans STATS_LINE_LENGTH
+//
+void startProfiler(){
+	loopProbe = profiler.addProbe(F("LOOP"));
+	keysProbe = profiler.addProbe(F("KEYS"));
+	collectProbe = profiler.addProbe(F("COLLECT"));
+	feedbackProbe = profiler.addProbe(F("FEEDBACK"));
+	recordProbe = profiler.addProbe(F("RECORD"));
+	serialProbe = profiler.addProbe(F("SERIAL"));
+}
+
+// Commande qui demande l'envoi des temps d'exécution mesurés par le profileur
+// Avec le paramètre RESET, les compteurs sont remis à zéro une fois envoyés: l'envoi suivant ne couvre que l'intervalle écoulé
+//
+void getStats(const CommandArg* arg){
+	isStatsReset = strcmp_P(arg->asString, PSTR("RESET")) == 0;
+	statsLine = 0;
+}
 
-		// On reprogramme le déclencheur suivant
-		secondDelay = SECOND_DELAY;
+// Procédure appelée à chaque itération qui envoie les temps d'exécution en microsecondes, trois lignes par sonde:
+//	- STATS:nom;exécutions;minimum;moyenne;maximum
+//	- STATS_BINS:nom;0;classe 0;...;classe 3 puis STATS_BINS:nom;4;classe 4;...;classe 7,
+//	  la classe i comptant les durées inférieures à 16 << i µs
+// L'histogramme est coupé en deux lignes pour qu'une ligne complète tienne dans le tampon d'envoi du port série
+// Comme pour l'historique, une ligne n'est envoyée que si le tampon d'envoi du port série peut la contenir
+//
+void flushStats(){
+	while(statsLine >= 0 && Serial.availableForWrite() >= STATS_LINE_LENGTH){
+		uint8_t id = statsLine / 3;
+		uint8_t part = statsLine % 3;
+		const Profiler::Probe* probe = profiler.getProbe(id);
+		if(probe == NULL){
+			if(isStatsReset) profiler.reset();
+			statsLine = -1;
+		}
+		else{
+			char string2Send[STATS_LINE_LENGTH] = "";
+			if(part == 0){
+				snprintf_P(string2Send, STATS_LINE_LENGTH, PSTR(";%u;%u;%u;%u"), probe->count,
+					probe->count > 0 ? probe->minimum : 0, profiler.getMean(id), probe->maximum);
+			}
+			else{
+				const uint16_t* bins = probe->bins + (part - 1) * STATS_BINS_PER_LINE;
+				snprintf_P(string2Send, STATS_LINE_LENGTH, PSTR(";%u;%u;%u;%u;%u"),
+					(part - 1) * STATS_BINS_PER_LINE, bins[0], bins[1], bins[2], bins[3]);
+			}
+			Serial.print(part == 0 ? F("STATS:") : F("STATS_BINS:"));
+			Serial.print(probe->name);
+			Serial.println(string2Send);
+			statsLine++;
+		}
 	}
+}
 
-	// Chaque minute...
-	if(minuteDelay == 0){
+// Procédure appelée à chaque période de mesure qui lance le cycle de mesure des sondes
+// Les corrections et l'envoi au PC sont faits par checkProbes() une fois les lectures terminées
+//
+void startProbesCycle(){
+	adaptWaterResolution();
+	getProbesValues();
+	isFeedbackPending = true;
+}
 
-		// On prend les mesures provenant des différentes sondes
-		getProbesValues();
+// Procédure qui adapte la résolution des sondes d'eau, avant chaque cycle de mesure, d'après la dernière mesure:
+// la zone la plus proche de la plage waterLow..waterHigh donne l'écart, toutes les sondes partageant la même conversion
+// Sans mesure récente, on garde la pleine résolution; sans programme, rien n'est régulé et la plus basse suffit
+// La résolution et la durée de conversion sont envoyées au PC au premier cycle puis à chaque changement
+//
+void adaptWaterResolution(){
+	uint8_t bits = WATER_RESOLUTION_MIN;
+	if(waterLow != FIXED_INVALID){
+		long gap = -1;
+		for(uint8_t zone = 0; zone < sensors.getZoneCount(); zone++){
+			fixed_t value = sensors.getZoneValue(zone, SENSOR_WATER_TEMPERATURE, sampleMaxAge);
+			if(value == FIXED_INVALID) continue;
+			long distance = value < waterLow ? (long)waterLow - value : value > waterHigh ? (long)value - waterHigh : 0;
+			if(gap < 0 || distance < gap) gap = distance;
+		}
+		if(gap < 0) bits = WATER_RESOLUTION_MAX;
+		else bits = WATER_RESOLUTION_MAX - min(gap / WATER_RESOLUTION_STEP, (long)(WATER_RESOLUTION_MAX - WATER_RESOLUTION_MIN));
+	}
+	if(bits != sensors.getResolution()) sensors.setResolution(bits);
+	if(sensors.getResolution() != waterResolution){
+		waterResolution = sensors.getResolution();
+		sendUSBValue(MSG_WATER_RESOLUTION, F("WATER_RESOLUTION"), (int)waterResolution);
+		sendUSBValue(MSG_CONVERSION_TIME, F("CONVERSION_TIME"), sensors.getConversionTime());
+	}
+}
 
-		// On prend une action corrective si une valeur dépasse les limites
-		provideFeedbacks();
+// Procédure appelée chaque quart d'heure qui envoie au PC le nombre cumulé d'échéances manquées par les tâches
+// On y joint la plus grande profondeur atteinte par la file d'attente de l'écran LCD
+// le nombre d'octets que les mises à jour partielles de l'écran ont évité d'envoyer
+// et le nombre cumulé de lignes reçues trop longues pour le tampon du port série
+//
+void sendSchedulerStats(){
+	sendUSBValue(MSG_OVERRUNS, F("OVERRUNS"), (int)scheduler.getTotalOverruns());
+	sendUSBValue(MSG_LCD_QUEUE, F("LCD_QUEUE"), (int)lcd.getQueueHighWater());
+	lcd.resetQueueHighWater();
+	sendUSBValue(MSG_LCD_SAVED, F("LCD_SAVED"), (int)constrain(lcd.getBytesSaved(), 0L, (long)INT_MAX));
+	lcd.resetBytesSaved();
+	sendUSBValue(MSG_SERIAL_OVERFLOWS, F("SERIAL_OVERFLOWS"), (int)serialLine.getOverflows());
+}
 
-		// On envoie les mesures provenant des différentes sondes vers le PC de surveillance
-		sendProbesValues();
+// Procédure appelée chaque quart d'heure qui envoie au PC l'état de la mémoire SRAM, en octets:
+//	- la mémoire libre entre le tas et la pile, blocs libres du tas compris
+//	- la marge de la pile: la plus petite distance entre la pile et le tas depuis le démarrage
+//	- la place libre dans le tas et son plus grand bloc libre, dont l'écart mesure la fragmentation
+// Une marge de pile qui approche de zéro annonce un plantage silencieux par débordement de la pile sur les variables
+//
+void sendMemoryStats(){
+	sendUSBValue(MSG_FREE_RAM, F("FREE_RAM"), (int)Memory::getFree());
+	sendUSBValue(MSG_STACK_MARGIN, F("STACK_MARGIN"), (int)Memory::getStackMargin());
+	sendUSBValue(MSG_HEAP_FREE, F("HEAP_FREE"), (int)Memory::getHeapFree());
+	sendUSBValue(MSG_HEAP_LARGEST, F("HEAP_LARGEST"), (int)Memory::getHeapLargest());
+}
 
-		// On reprogramme le déclencheur suivant
-		minuteDelay = MINUTE_DELAY;
+// Procédure appelée à chaque itération qui envoie les mesures en attente de l'historique
+// Une mesure n'est envoyée que si le tampon d'envoi du port série peut la contenir: la boucle principale n'est jamais bloquée
+// et le reste du lot part aux itérations suivantes
+// La phrase envoyée est du type HISTORY:sequence;heure;température air;humidité air;température eau;zone
+// L'historique part en texte même en mode binaire: une trame binaire ne porte qu'une valeur, sans séquence, heure ni zone
+//
+void flushHistory(){
+	while(isHistoryFlushing && Serial.availableForWrite() >= HISTORY_LINE_LENGTH){
+		const History::Record* record = history.nextPending();
+		if(record == NULL) isHistoryFlushing = false;
+		else{
+			char string2Send[HISTORY_LINE_LENGTH] = "";
+			snprintf_P(string2Send, HISTORY_LINE_LENGTH, PSTR("HISTORY:%u;%lu;%d;%d;%d;%u"), record->sequence, record->time,
+				record->airTemperature, record->airHumidity, record->waterTemperature, record->zone);
+			Serial.println(string2Send);
+		}
 	}
+}
 
-	// Chaque quart d'heure...
-	if(quarterDelay == 0){
-
-		// On reprogramme le déclencheur suivant
-		quarterDelay = QUARTER_DELAY;
+// Commande qui demande l'envoi de l'historique des mesures
+// Sans paramètre, on envoie les mesures en attente; avec un numéro de séquence, on renvoie les mesures à partir de celle-ci,
+// ou à partir de la plus ancienne encore conservée si elle a déjà été écrasée
+// Dans ce dernier cas, on répond d'abord HISTORY_FROM:sequence pour que le PC sache où reprend l'envoi
+//
+void getHistory(const CommandArg* arg){
+	if(*arg->asString != '\0'){
+		Serial.print(F("HISTORY_FROM:"));
+		Serial.println(history.rewind(strtoul(arg->asString, NULL, 10)));
 	}
+	isHistoryFlushing = true;
+}
+
+// Commande qui règle en secondes la période de mesure des sondes, qui est aussi la période de l'historique
+// L'âge maximal des mesures utilisables suit la nouvelle période
+//
+void setHistoryRate(const CommandArg* arg){
+	long rate = constrain(arg->asInt, HISTORY_MIN_RATE, HISTORY_MAX_RATE);
+	scheduler.setPeriod(probesTask, 1000UL * rate);
+	sampleMaxAge = SAMPLE_MAX_PERIODS * 1000UL * rate;
 }
@@ -0,0 +1,62 @@
+/*
+		test_pid.cpp - Tests de la librairie PID dans l'environnement native (pio test -e native)
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+*/
+
+#include <unity.h>
+#include <PID.h>
+
+// Fenêtre la plus longue acceptée par le firmware pour la résistance chauffante, en secondes
+#define TEST_WINDOW 1800
+
+// Consigne des tests, en centièmes de degré
+#define TEST_SETPOINT 2300
+
+// Régulateur purement intégral au gain maximal
+//
+static void setIntegralOnly(PID* pid){
+	pid->setGains(0, (long)PID_KI_MAX << PID_GAIN_SHIFT, 0);
+}
+
+// Un écart maximal positif pendant la plus longue fenêtre sature la sortie au lieu de déborder
+//
+void test_integral_positive_error_long_window(){
+	PID pid;
+	setIntegralOnly(&pid);
+	TEST_ASSERT_EQUAL_INT(PID_OUTPUT_MAX, pid.compute(TEST_SETPOINT, TEST_SETPOINT - PID_ERROR_MAX, TEST_WINDOW));
+}
+
+// Un écart maximal négatif pendant la plus longue fenêtre laisse la sortie à zéro au lieu de déborder
+//
+void test_integral_negative_error_long_window(){
+	PID pid;
+	setIntegralOnly(&pid);
+	TEST_ASSERT_EQUAL_INT(0, pid.compute(TEST_SETPOINT, TEST_SETPOINT + PID_ERROR_MAX, TEST_WINDOW));
+}
+
+// Une intégrale saturée est entièrement vidée par un écart maximal négatif pendant la plus longue fenêtre
+//
+void test_integral_reverses_long_window(){
+	PID pid;
+	setIntegralOnly(&pid);
+	pid.compute(TEST_SETPOINT, TEST_SETPOINT - PID_ERROR_MAX, TEST_WINDOW);
+	TEST_ASSERT_EQUAL_INT(0, pid.compute(TEST_SETPOINT, TEST_SETPOINT + PID_ERROR_MAX, TEST_WINDOW));
+}
+
+// Un petit écart sur une fenêtre courte s'intègre toujours: 1°C pendant une minute au gain de 10‰/°C/min
+//
+void test_integral_small_step(){
+	PID pid;
+	pid.setGains(0, 10L << PID_GAIN_SHIFT, 0);
+	TEST_ASSERT_EQUAL_INT(10, pid.compute(TEST_SETPOINT, TEST_SETPOINT - 100, 60));
+}
+
+int main(int argc, char** argv){
+	UNITY_BEGIN();
+	RUN_TEST(test_integral_positive_error_long_window);
+	RUN_TEST(test_integral_negative_error_long_window);
+	RUN_TEST(test_integral_reverses_long_window);
+	RUN_TEST(test_integral_small_step);
+	return UNITY_END();
+}
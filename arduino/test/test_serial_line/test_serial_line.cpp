@@ -0,0 +1,86 @@
+/*
+		test_serial_line.cpp - Tests de la librairie SerialLine dans l'environnement native (pio test -e native)
+		Ecrit par Christophe BURY
+		Date de première release: 17/10/2026
+*/
+
+#include <string.h>
+#include <unity.h>
+#include <SerialLine.h>
+
+// Port série simulé, qui restitue une chaîne fixée à l'avance
+//
+class TextStream : public Stream{
+
+	public:
+		TextStream(const char* text){
+			this->text = text;
+		}
+		virtual int available(){
+			return strlen(text);
+		}
+		virtual int read(){
+			return *text != '\0' ? *text++ : -1;
+		}
+		virtual int peek(){
+			return *text != '\0' ? *text : -1;
+		}
+		virtual size_t write(uint8_t byte){
+			return 1;
+		}
+
+	private:
+		const char* text;
+};
+
+// Une ligne avec séparateur est découpée en commande et paramètre
+//
+void test_split_with_param(){
+	TextStream stream("STATS:ALL\n");
+	SerialLine line(&stream);
+	SerialLine::Token command;
+	SerialLine::Token param;
+	TEST_ASSERT_TRUE(line.read());
+	TEST_ASSERT_TRUE(line.split(':', &command, &param));
+	TEST_ASSERT_EQUAL_STRING("STATS", command.text);
+	TEST_ASSERT_EQUAL_INT(5, command.length);
+	TEST_ASSERT_EQUAL_STRING("ALL", param.text);
+	TEST_ASSERT_EQUAL_INT(3, param.length);
+}
+
+// Une ligne sans séparateur est entièrement la commande, avec un paramètre vide
+//
+void test_split_bare_command(){
+	TextStream stream("STATS\r\n");
+	SerialLine line(&stream);
+	SerialLine::Token command;
+	SerialLine::Token param;
+	TEST_ASSERT_TRUE(line.read());
+	TEST_ASSERT_FALSE(line.split(':', &command, &param));
+	TEST_ASSERT_EQUAL_STRING("STATS", command.text);
+	TEST_ASSERT_EQUAL_INT(5, command.length);
+	TEST_ASSERT_EQUAL_STRING("", param.text);
+	TEST_ASSERT_EQUAL_INT(0, param.length);
+}
+
+// Une commande suivie d'un séparateur sans paramètre donne aussi un paramètre vide
+//
+void test_split_empty_param(){
+	TextStream stream("GET_HISTORY:\n");
+	SerialLine line(&stream);
+	SerialLine::Token command;
+	SerialLine::Token param;
+	TEST_ASSERT_TRUE(line.read());
+	TEST_ASSERT_TRUE(line.split(':', &command, &param));
+	TEST_ASSERT_EQUAL_STRING("GET_HISTORY", command.text);
+	TEST_ASSERT_EQUAL_STRING("", param.text);
+	TEST_ASSERT_EQUAL_INT(0, param.length);
+}
+
+int main(int argc, char** argv){
+	UNITY_BEGIN();
+	RUN_TEST(test_split_with_param);
+	RUN_TEST(test_split_bare_command);
+	RUN_TEST(test_split_empty_param);
+	return UNITY_END();
+}
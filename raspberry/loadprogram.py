@@ -2,6 +2,7 @@
 # -*- coding: utf-8 -*-
 
 import ConfigParser
+from telemetry import Telemetry
 
 # Classe permettant de charger les programmes de germination
 #
@@ -11,18 +12,50 @@ class LoadProgram:
 	#
 	PROGRAMS_FILE = 'programs.cfg'
 
+	# Longueur maximale d'une ligne reçue par l'unité de germination, fin de ligne non comprise
+	# Elle doit correspondre à SERIAL_LINE_LENGTH de arduino/lib/SerialLine-library/SerialLine.h
+	LINE_LENGTH = 127
+
+	# Paramètres transmis dans la trame SET_PROGRAM_BLOCK, dans l'ordre attendu par l'unité de germination
+	# L'heure courante est insérée entre le nom du programme et le premier de ces paramètres
+	BLOCK_PARAMETERS = ['light.red', 'light.green', 'light.blue', 'light.on', 'light.off',
+											'water.flow.on', 'water.flow.off',
+											'water.temperature.low', 'water.temperature.high',
+											'air.temperature.low', 'air.temperature.high',
+											'water.pid.kp', 'water.pid.ki', 'water.pid.kd',
+											'water.heat.window', 'water.heat.minimum']
+
+	# Valeurs utilisées pour les paramètres absents d'un programme
+	# Elles permettent de charger un programme écrit avant l'ajout de la régulation PID de l'eau
+	DEFAULT_PARAMETERS = {'water.pid.kp': '300', 'water.pid.ki': '5', 'water.pid.kd': '0',
+												'water.heat.window': '1200', 'water.heat.minimum': '600'}
+
 	# Méthode récupérant la valeur d'un paramètre du programme
 	#
 	def getParameter(self, parameter):
 
-		# La valeur du paramètre n'a pas encore été trouvée
-		value = None
+		# La valeur du paramètre n'a pas encore été trouvée, on part de sa valeur par défaut s'il en a une
+		value = self.DEFAULT_PARAMETERS.get(parameter)
 
 		# Cherche la valeur du paramètre pour le programme chargé à partir du fichier
 		if parameter in self.program:
 			value = self.program[parameter]
 		return value
 
+	# Méthode construisant la trame SET_PROGRAM_BLOCK qui transporte tout le programme en une seule fois
+	# Les champs sont séparés par des ';' et la trame se termine par '*' suivi du CRC16 en hexadécimal
+	# Cette méthode prend un paramètre en entrée:
+	#		* timestamp: l'heure locale à régler sur l'unité, en secondes depuis le 1er janvier 1970
+	# Retourne None si la trame est plus longue que ce que l'unité peut recevoir: elle serait refusée à chaque envoi
+	#
+	def getProgramBlock(self, timestamp):
+		fields = [self.programName, str(timestamp)] + [self.getParameter(parameter) for parameter in self.BLOCK_PARAMETERS]
+		block = ';'.join(fields)
+		frame = 'SET_PROGRAM_BLOCK:' + block + '*%04X' % Telemetry.crc16(block)
+		if len(frame) > self.LINE_LENGTH:
+			return None
+		return frame
+
 	# Constructeur de la classe
 	# Ce constructeur prend un paramètre en entrée:
 	#		* locale: la locale utilisée dans le programme
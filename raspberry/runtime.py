@@ -5,7 +5,8 @@
 import os
 import logging
 import logging.config
-from time import time, sleep, strftime
+import threading
+from time import time, sleep, strftime, gmtime
 import serial
 from usb import USBDaemon
 from loadprogram import LoadProgram
@@ -28,6 +29,27 @@ ARDUINO_SPEED = 115200
 ARDUINO_CONNECT_WAIT = 2;	
 ARDUINO_CONNECT_RETRY = 10;	
 
+# Les mesures sont demandées en trames binaires plutôt qu'en texte si l'unité de germination le supporte
+ARDUINO_BINARY_TELEMETRY = True
+
+# Période en secondes des mesures enregistrées dans l'historique de l'unité de germination
+ARDUINO_HISTORY_RATE = 60
+
+# Période en secondes de la demande de l'historique: sans elle, l'unité n'envoie ses mesures que par lots,
+# une fois la moitié de son historique remplie, soit avec une douzaine de minutes de retard
+ARDUINO_HISTORY_POLL = ARDUINO_HISTORY_RATE
+
+# Nombre de classes de l'histogramme des temps d'exécution envoyé par le profileur de l'unité de germination
+STATS_BINS = 8
+
+# Marge de pile en octets en dessous de laquelle on signale un risque de plantage de l'unité de germination
+STACK_MARGIN_WARNING = 128
+
+# Plus basse mesure possible des capteurs de l'unité (-55°C pour la DS18B20), en centièmes
+# En dessous, la valeur de l'historique est un code d'erreur et non une mesure: -256.00 pour une zone sans mesure valide,
+# -127.00 pour une sonde DS18B20 déconnectée
+MEASURE_MIN = -5500
+
 # Définition des paramètres de configuration pour les services internet
 HTTP_BASE_URL = 'https://vertx.zetof.net'
 HTTP_USER = 'vertx'
@@ -37,6 +59,11 @@ HTTP_TIMEOUT = 2
 # On n'est pas en phase de quitter le programme
 running = True
 
+# Numéro de séquence attendu pour la prochaine mesure de l'historique (inconnu au démarrage)
+# et indicateur d'une demande de renvoi en cours après la détection d'un trou
+historyNext = None
+historyRequested = False
+
 # Lecture du programme de germination à dérouler
 program = LoadProgram(PROGRAM)
 
@@ -85,33 +112,25 @@ def arduinoReadProblem(data):
 def initArduino(data):
 
 	# Traitement des différents cas d'initialisation / envoi des paramètres du programma
+	# Le programme complet est envoyé en une seule trame protégée par un CRC
 	#
-	if data == 'GET_PROGRAM':
-		arduino.sendCommand('SET_PROGRAM:' + program.programName)
-	elif data == 'GET_TIME':
-		arduino.sendCommand('SET_TIME:' + str(int(time()) + 3600 * GMT))
-	elif data == 'GET_RED_LEVEL':
-		arduino.sendCommand('SET_RED_LEVEL:' + program.getParameter('light.red'))
-	elif data == 'GET_GREEN_LEVEL':
-		arduino.sendCommand('SET_GREEN_LEVEL:' + program.getParameter('light.green'))
-	elif data == 'GET_BLUE_LEVEL':
-		arduino.sendCommand('SET_BLUE_LEVEL:' + program.getParameter('light.blue'))
-	elif data == 'GET_LIGHT_ON':
-		arduino.sendCommand('SET_LIGHT_ON:' + program.getParameter('light.on'))
-	elif data == 'GET_LIGHT_OFF':
-		arduino.sendCommand('SET_LIGHT_OFF:' + program.getParameter('light.off'))
-	elif data == 'GET_FLOW_ON':
-		arduino.sendCommand('SET_FLOW_ON:' + program.getParameter('water.flow.on'))
-	elif data == 'GET_FLOW_OFF':
-		arduino.sendCommand('SET_FLOW_OFF:' + program.getParameter('water.flow.off'))
-	elif data == 'GET_WATER_LOW':
-		arduino.sendCommand('SET_WATER_LOW:' + program.getParameter('water.temperature.low'))
-	elif data == 'GET_WATER_HIGH':
-		arduino.sendCommand('SET_WATER_HIGH:' + program.getParameter('water.temperature.high'))
-	elif data == 'GET_AIR_LOW':
-		arduino.sendCommand('SET_AIR_LOW:' + program.getParameter('air.temperature.low'))
-	elif data == 'GET_AIR_HIGH':
-		arduino.sendCommand('SET_AIR_HIGH:' + program.getParameter('air.temperature.high'))
+	if data == 'GET_PROGRAM_BLOCK':
+		programBlock = program.getProgramBlock(int(time()) + 3600 * GMT)
+		if programBlock != None:
+			arduino.sendCommand(programBlock)
+		else:
+			logger.error('Programme ' + program.programName + ' trop long pour l\'unité de germination, il n\'est pas envoyé')
+	elif data == 'PROGRAM_BLOCK_OK':
+		logger.info('Programme ' + program.programName + ' chargé dans l\'unité de germination')
+		if ARDUINO_BINARY_TELEMETRY:
+			arduino.sendCommand('SET_TELEMETRY:BINARY')
+		arduino.sendCommand('SET_HISTORY_RATE:' + str(ARDUINO_HISTORY_RATE))
+	elif data == 'PROGRAM_BLOCK_ERROR':
+		logger.warning('Programme refusé par l\'unité de germination, il sera renvoyé à la prochaine demande')
+	elif data == 'TELEMETRY_BINARY':
+		logger.info('Réception des mesures en trames binaires')
+	elif data == 'TELEMETRY_TEXT':
+		logger.info('Réception des mesures en texte')
 
 # Fonction qui enregistre une action ou une valeur de paramètre provenant de l'unité de germination
 #
@@ -147,15 +166,152 @@ def logInfo(data):
 	elif action == 'FAN':
 		logger.info('Réglage du ventilateur à ' + value + '% de la puissance')
 		# dbStore('fan_state', value)
-	elif action == 'AIR_TEMP':
-		logger.info('Température de l\'air: ' + value + '°C')
-		# dbStore('air_temp', value)
-	elif action == 'AIR_HUM':
-		logger.info('Humidité de l\'air: ' + value + '%')
-		# dbStore('air_hum', value)
-	elif action == 'WATER_TEMP':
-		logger.info('Température de l\'eau: ' + value + '°C')
-		# dbStore('water_temp', value)
+	elif action == 'OVERRUNS':
+		logger.debug('Echéances manquées par les tâches de l\'unité: ' + value)
+	elif action == 'LCD_QUEUE':
+		logger.debug('Profondeur maximale de la file d\'attente de l\'écran LCD: ' + value + ' octets')
+	elif action == 'LCD_SAVED':
+		logger.debug('Octets économisés par les mises à jour partielles de l\'écran LCD: ' + value)
+	elif action == 'HEAT_DUTY':
+		logger.debug('Puissance de la résistance chauffante sur la fenêtre: ' + value + '‰')
+	elif action == 'PID_KP':
+		logger.info('Gain proportionnel de la régulation de l\'eau: ' + value + '‰/°C')
+	elif action == 'PID_KI':
+		logger.info('Gain intégral de la régulation de l\'eau: ' + value + '‰/°C/min')
+	elif action == 'PID_KD':
+		logger.info('Gain dérivé de la régulation de l\'eau: ' + value + '‰/(°C/min)')
+	elif action == 'HEAT_WINDOW':
+		logger.info('Fenêtre de la résistance chauffante: ' + value + 's')
+	elif action == 'HEAT_MIN':
+		logger.info('Durée minimale de marche ou d\'arrêt de la résistance chauffante: ' + value + 's')
+	elif action == 'FREE_RAM':
+		logger.debug('Mémoire SRAM libre de l\'unité: ' + value + ' octets')
+	elif action == 'STACK_MARGIN':
+		logger.debug('Marge minimale de la pile depuis le démarrage: ' + value + ' octets')
+		if int(value) < STACK_MARGIN_WARNING:
+			logger.warning('La pile de l\'unité de germination approche du tas: ' + value + ' octets de marge')
+	elif action == 'HEAP_FREE':
+		logger.debug('Place libre dans le tas: ' + value + ' octets')
+	elif action == 'HEAP_LARGEST':
+		logger.debug('Plus grand bloc libre du tas: ' + value + ' octets')
+	elif action == 'PROBES_DOWN':
+		mask = int(value)
+		if mask != 0:
+			down = [str(probe) for probe in range(16) if mask & (1 << probe)]
+			logger.warning('Sonde(s) en panne dans l\'unité de germination: ' + ', '.join(down))
+		else:
+			logger.info('Toutes les sondes de l\'unité de germination fonctionnent')
+	elif action == 'WATER_RESOLUTION':
+		logger.debug('Résolution des sondes d\'eau: ' + value + ' bits')
+	elif action == 'CONVERSION_TIME':
+		logger.debug('Durée de conversion des sondes d\'eau: ' + value + 'ms')
+	elif action == 'SERIAL_OVERFLOWS':
+		logger.debug('Lignes trop longues tronquées par l\'unité depuis son démarrage: ' + value)
+
+# Fonction qui enregistre une mesure de l'historique provenant de l'unité de germination
+# Le message est du type sequence;heure;température air;humidité air;température eau;zone, les valeurs étant multipliées par 100
+# Une unité qui ne connaît pas les zones n'envoie pas la zone: les mesures sont alors celles de la zone 0
+# Une valeur d'erreur (sonde déconnectée ou en panne) est journalisée comme indisponible et n'est jamais enregistrée
+# Si une mesure manque, on redemande l'historique à partir de celle-ci et on ignore les mesures suivantes
+# jusqu'à la réponse HISTORY_FROM de l'unité
+#
+def logHistory(data):
+	global historyNext, historyRequested
+
+	# On découpe la mesure
+	splitData = data.split(';')
+	sequence = int(splitData[0])
+	timestamp = strftime('%d/%m/%Y %H:%M:%S', gmtime(int(splitData[1])))
+	airTemperature = toMeasure(splitData[2])
+	airHumidity = toMeasure(splitData[3])
+	waterTemperature = toMeasure(splitData[4])
+	zone = int(splitData[5]) if len(splitData) > 5 else 0
+
+	# On vérifie la séquence, modulo 65536
+	if historyNext != None and sequence != historyNext:
+
+		# Mesure déjà reçue ou en avance sur une demande de renvoi en cours: on l'ignore
+		gap = (sequence - historyNext) % 65536
+		if gap >= 32768 or historyRequested:
+			return
+
+		# Mesures manquantes: on les redemande
+		logger.warning('Historique: ' + str(gap) + ' mesure(s) manquante(s), renvoi demandé')
+		arduino.sendCommand('GET_HISTORY:' + str(historyNext))
+		historyRequested = True
+		return
+
+	historyNext = (sequence + 1) % 65536
+	logger.info('Mesures du ' + timestamp + ' en zone ' + str(zone) + ': air ' + formatMeasure(airTemperature, '°C') + ', ' + formatMeasure(airHumidity, '%') + ', eau ' + formatMeasure(waterTemperature, '°C'))
+	# if airTemperature != None: dbStore('air_temp', airTemperature)
+	# if airHumidity != None: dbStore('air_hum', airHumidity)
+	# if waterTemperature != None: dbStore('water_temp', waterTemperature)
+
+# Fonction qui convertit une valeur de l'historique, en centièmes, dans l'unité de la mesure
+# Retourne None pour un code d'erreur de l'unité de germination
+#
+def toMeasure(text):
+	value = int(text)
+	if value < MEASURE_MIN:
+		return None
+	return value / 100.0
+
+# Fonction qui écrit une mesure pour le journal, ou indique qu'elle est indisponible
+#
+def formatMeasure(value, unit):
+	if value == None:
+		return 'indisponible'
+	return '%.2f' % value + unit
+
+# Fonction qui traite la réponse de l'unité de germination à une demande de renvoi de l'historique
+# L'unité reprend à la séquence demandée, ou à la plus ancienne qu'elle possède encore si les mesures demandées ont été écrasées
+#
+def resumeHistory(data):
+	global historyNext, historyRequested
+
+	sequence = int(data)
+	if historyNext != None and sequence != historyNext:
+		logger.warning('Historique: ' + str((sequence - historyNext) % 65536) + ' mesure(s) perdue(s) par l\'unité de germination')
+	historyNext = sequence
+	historyRequested = False
+
+# Fonction qui demande régulièrement l'historique de l'unité de germination pour suivre les mesures en direct
+# Elle tourne en thread et se reprogramme tant que le programme principal n'a pas demandé un arrêt
+# Une demande de renvoi en cours suffit: les mesures en attente partiront à sa suite
+#
+def pollHistory():
+	if running == True:
+		if not historyRequested:
+			try:
+				arduino.sendCommand('GET_HISTORY:')
+			except serial.SerialException as e:
+				logger.warning('Demande de l\'historique impossible, elle sera refaite à la prochaine période')
+		pollTimer = threading.Timer(ARDUINO_HISTORY_POLL, pollHistory)
+		pollTimer.daemon = True
+		pollTimer.start()
+
+# Fonction qui enregistre les temps d'exécution mesurés par le profileur de l'unité de germination, en microsecondes
+# Le message STATS est du type nom;exécutions;minimum;moyenne;maximum
+#
+def logStats(data):
+	splitData = data.split(';')
+	logger.debug('Temps d\'exécution de ' + splitData[0] + ': ' + splitData[1] + ' exécution(s), min ' + splitData[2] + 'µs, moyenne ' + splitData[3] + 'µs, max ' + splitData[4] + 'µs')
+
+# Fonction qui enregistre une partie de l'histogramme des temps d'exécution d'une sonde du profileur
+# Le message STATS_BINS est du type nom;première classe;classe;...: l'histogramme arrive en plusieurs messages
+# pour que chaque ligne tienne dans le tampon d'envoi de l'unité. La classe i compte les durées inférieures à 16 << i µs,
+# la dernière toutes les durées plus longues
+#
+def logStatsBins(data):
+	splitData = data.split(';')
+	first = int(splitData[1])
+	bins = []
+	for i, count in enumerate(splitData[2:], first):
+		if i < STATS_BINS - 1:
+			bins.append('<' + str(16 << i) + 'µs: ' + count)
+		else:
+			bins.append('>=' + str(16 << (i - 1)) + 'µs: ' + count)
+	logger.debug('Histogramme de ' + splitData[0] + ': ' + ', '.join(bins))
 
 # Définition du callback lors de la réception d'un message venant d'un Arduino
 # Ce callback prend en compte l'analyse des messages venant d'un Arduino et
@@ -169,7 +325,11 @@ def processDataFromArduino(receivedData):
 	# On définit un dictionnaire pour le traitement des différents messages
 	action = {'ARDUINO_READ': arduinoReadProblem,
 						'INIT': initArduino,
-						'INFO': logInfo}
+						'INFO': logInfo,
+						'HISTORY': logHistory,
+						'HISTORY_FROM': resumeHistory,
+						'STATS': logStats,
+						'STATS_BINS': logStatsBins}
 	
 	# Finalement, on appelle la fonction correspondante à la commande sur base du dictionnaire
 	# Si la clé n'existe pas, il est nécessaire d'intercepter l'erreur pour éviter tout problème
@@ -211,6 +371,9 @@ while arduino == None:
 logger.info('Démarrage du programme de contrôle\n***\n*** Démarrage de l\'unité de germination ***\n***')
 # dbStore('app_start', program.programName)
 
+# On demande régulièrement l'historique des mesures
+pollHistory()
+
 # On attend la fin du programme demandée par l'utilisateur
 while running == True:
 
@@ -218,9 +381,12 @@ while running == True:
 	printProgram()
 
 	# A tout moment, l'utilisateur peut quitter le programme en entrant le mot 'exit'
-	userInput = raw_input('Pour terminer le PGM, entrer \'exit\': ')
+	# ou demander les temps d'exécution mesurés par l'unité (remis à zéro après l'envoi) avec le mot 'stats'
+	userInput = raw_input('Pour terminer le PGM, entrer \'exit\' (\'stats\' pour les temps d\'exécution): ')
 	if userInput.strip() == 'exit':
 		running = False
+	elif userInput.strip() == 'stats':
+		arduino.sendCommand('STATS:RESET')
 
 # On fait le ménage à la sortie de la boucle principale, avant d'aller faire dodo
 arduino.stop()
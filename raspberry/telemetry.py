@@ -0,0 +1,99 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+
+import struct
+
+# Classe permettant de décoder les trames binaires de mesures envoyées par l'unité de germination
+# Une trame est encodée par COBS et entourée de deux octets nuls. Une fois décodée, elle contient
+# l'identifiant de la mesure (1 octet), sa valeur (entier signé 32 bits little-endian) et le CRC16
+# des 5 octets précédents (little-endian). Les réels sont transmis multipliés par 100
+#
+class Telemetry:
+
+	# Liste des constantes
+	#
+	DELIMITER = '\x00'				# Octet délimitant les trames binaires
+	RAW_LENGTH = 7						# Longueur d'une trame décodée
+	FRAME_LENGTH = 10					# Longueur d'une trame envoyée: les deux délimiteurs et la trame encodée (un octet de plus)
+
+	# Types de mesures: état ON/OFF, entier ou réel en virgule fixe à deux décimales
+	STATE = 0
+	INTEGER = 1
+	FIXED = 2
+
+	# Identifiants fixes des mesures, ils doivent correspondre à ceux de arduino/src/runtime.cpp
+	# Les identifiants 5 à 7 ne sont plus utilisés: les mesures des sondes arrivent par l'historique, toujours en texte
+	# L'identifiant 8 n'est plus utilisé non plus
+	MESSAGES = {1: ('FLOW', STATE),
+							2: ('HEAT', STATE),
+							3: ('LIGHT', STATE),
+							4: ('FAN', INTEGER),
+							9: ('OVERRUNS', INTEGER),
+							10: ('LCD_QUEUE', INTEGER),
+							11: ('LCD_SAVED', INTEGER),
+							12: ('HEAT_DUTY', INTEGER),
+							13: ('PID_KP', FIXED),
+							14: ('PID_KI', FIXED),
+							15: ('PID_KD', FIXED),
+							16: ('HEAT_WINDOW', INTEGER),
+							17: ('HEAT_MIN', INTEGER),
+							18: ('FREE_RAM', INTEGER),
+							19: ('STACK_MARGIN', INTEGER),
+							20: ('HEAP_FREE', INTEGER),
+							21: ('HEAP_LARGEST', INTEGER),
+							22: ('PROBES_DOWN', INTEGER),
+							23: ('WATER_RESOLUTION', INTEGER),
+							24: ('CONVERSION_TIME', INTEGER),
+							25: ('SERIAL_OVERFLOWS', INTEGER)}
+
+	# Méthode calculant le CRC16 d'une chaîne, identique à celui utilisé sur le bus 1-Wire (OneWire::crc16)
+	#
+	@staticmethod
+	def crc16(data):
+		crc = 0
+		for c in data:
+			crc ^= ord(c)
+			for i in range(8):
+				if crc & 1:
+					crc = (crc >> 1) ^ 0xA001
+				else:
+					crc >>= 1
+		return crc
+
+	# Méthode décodant une trame COBS, délimiteurs exclus
+	# Retourne None si la trame est mal formée
+	#
+	@staticmethod
+	def cobsDecode(frame):
+		data = ''
+		index = 0
+		while index < len(frame):
+			code = ord(frame[index])
+			if code == 0 or index + code > len(frame):
+				return None
+			data += frame[index + 1:index + code]
+			index += code
+			if code < 0xFF and index < len(frame):
+				data += '\x00'
+		return data
+
+	# Méthode transformant une trame binaire en message identique à celui du protocole texte (ex: INFO:PID_KP=0.50)
+	# Les messages produits suivent donc le même traitement que ceux reçus en mode texte
+	# Retourne None si la trame est corrompue ou si la mesure est inconnue
+	#
+	@staticmethod
+	def decode(frame):
+		data = Telemetry.cobsDecode(frame)
+		if data == None or len(data) != Telemetry.RAW_LENGTH:
+			return None
+		identifier, value, crc = struct.unpack('<BiH', data)
+		if crc != Telemetry.crc16(data[:5]) or identifier not in Telemetry.MESSAGES:
+			return None
+		name, kind = Telemetry.MESSAGES[identifier]
+		if kind == Telemetry.STATE:
+			value = 'ON' if value else 'OFF'
+		elif kind == Telemetry.FIXED:
+			value = '%.2f' % (value / 100.0)
+		else:
+			value = str(value)
+		return 'INFO:' + name + '=' + value
@@ -5,6 +5,7 @@ from time import sleep
 import threading
 import serial
 import logging
+from telemetry import Telemetry
 
 # Classe implémentant la communication série entre le Raspberry et les Arduinos sur un port USB
 #
@@ -16,6 +17,7 @@ class USBDaemon:
 	READ_TIME = 0.1						# Durée entre deux lectures du port USB en secondes
 	RECONNECT_TIME = 5				# Durée entre deux tentatives de reconnexion
 	NBR_OF_RECONNECTIONS = 3	# Nombre de tentatives de reconnexion avant la levée d'une alarme
+	READ_TIMEOUT = 0.5				# Attente maximale d'un octet au milieu d'une ligne ou d'une trame en secondes
 
 	# Méthode qui tourne constamment en thread, lancée par le constructeur
 	# Ecoute le port USB en provenance de l'Arduino
@@ -27,12 +29,25 @@ class USBDaemon:
 		if self.running == True:
 
 			# On ne lit que si des données sont présentes
+			# Une trame binaire commence par un octet nul, qui n'apparaît jamais dans une ligne de texte
+			# Elle est décodée en un message identique à celui du protocole texte
+			# Une ligne interrompue par un octet nul est un débris: on l'abandonne pour lire la trame qui commence
 			try:
-				if self.arduino.inWaiting() > 0:
-					self.messageReceived = self.arduino.readline().strip()
-
-					# On appelle le callback pour traitement du message
-					self.callback(self.messageReceived)
+				while self.arduino.inWaiting() > 0:
+					firstByte = self.arduino.read()
+					self.messageReceived = None
+					if firstByte != Telemetry.DELIMITER:
+						self.messageReceived = self.__readLine(firstByte)
+					if self.messageReceived == None:
+						frame = self.__readFrame()
+						if frame != None:
+							self.messageReceived = Telemetry.decode(frame)
+						if self.messageReceived == None:
+							self.messageReceived = 'ARDUINO_READ:WARNING'
+
+					# On appelle le callback pour traitement du message, une ligne vide ou incomplète est ignorée
+					if self.messageReceived != '':
+						self.callback(self.messageReceived)
 
 			# On a un incident à la lecture du port USB
 			except IOError as e:
@@ -72,13 +87,55 @@ class USBDaemon:
 			readTimer = threading.Timer(self.READ_TIME, self.__listenUSB)
 			readTimer.start()
 
+	# Méthode lisant une ligne de texte jusqu'à sa fin, son premier octet ayant déjà été lu
+	# Retourne la ligne sans ses caractères de fin, une chaîne vide si le délai de lecture expire avant la fin de la ligne
+	# ou None si un délimiteur de trame binaire interrompt la ligne: ce délimiteur est alors le début d'une trame
+	#
+	def __readLine(self, firstByte):
+		line = firstByte
+		while True:
+			data = self.arduino.read()
+			if data == '':
+				return ''
+			elif data == Telemetry.DELIMITER:
+				return None
+			elif data == '\n':
+				return line.strip()
+			line += data
+
+	# Méthode lisant une trame binaire jusqu'à son délimiteur de fin, le délimiteur de début ayant déjà été lu
+	# Deux délimiteurs qui se suivent signalent une fin de trame prise pour un début: le second commence la trame
+	# Une trame plus longue que Telemetry.FRAME_LENGTH ne peut venir que d'une désynchronisation: elle est abandonnée
+	# avec un avertissement, et on se recale sur le délimiteur suivant, pris comme début de trame
+	# Retourne la trame encodée, délimiteurs exclus, ou None si le délai de lecture expire
+	#
+	def __readFrame(self):
+		frame = ''
+		while True:
+			data = self.arduino.read()
+			if data == '':
+				return None
+			elif data == Telemetry.DELIMITER:
+				if frame != '':
+					return frame
+			elif len(frame) < Telemetry.FRAME_LENGTH - 2:
+				frame += data
+			else:
+				self.callback('ARDUINO_READ:WARNING')
+				frame = ''
+				while data != Telemetry.DELIMITER:
+					data = self.arduino.read()
+					if data == '':
+						return None
+
 	# Méthode permettant d'ouvrir la connexion au port USB
 	#
 	def __openUSB(self):
 
 		# On essaie de créer l'objet de communication avec les valeurs d'initialisation
 		try:
-			self.arduino = serial.Serial(self.serialName, self.serialSpeed)
+			# Le délai de lecture évite qu'une trame ou une ligne tronquée bloque indéfiniment l'écoute
+			self.arduino = serial.Serial(self.serialName, self.serialSpeed, timeout=self.READ_TIMEOUT)
 
 			# On supprime tout buffer pour être sûr de ne pas avoir de débris de communication
 			self.arduino.flushInput()